@@ -0,0 +1,396 @@
+/**
+ * Microbenchmarks for the wrapper overhead compared with equivalent loops over the raw SQLite C API.
+ *
+ * Usage: wrapper_benchmark [iterations]
+ *
+ * Each benchmark reports nanoseconds per operation, C++ heap allocations per operation and, for the row scans, rows
+ * per second. Only allocations through operator new are counted, not the allocations made by SQLite. Every benchmark
+ * runs on an in-memory database and on a database file.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <sqlitelib.hpp>
+
+using std::string;
+using std::vector;
+
+using SQLite = sqlitelib::SQLite3::sqlite;
+using PreparedStatement = sqlitelib::SQLite3::prepared_statement;
+using StepStatementProcessing = sqlitelib::SQLite3::StepStatementProcessing;
+using RowProcessor = sqlitelib::SQLite3::exec_result;
+using StreamProcessor = sqlitelib::SQLite3::exec_stream;
+using ResultRow = sqlitelib::SQLite3::result_row;
+using TextView = sqlitelib::SQLite3::text_view;
+using BlobSpan = sqlitelib::SQLite3::blob_span;
+
+// Number of rows in the table that is scanned.
+static const int ScanRows = 10000;
+
+// Number of C++ heap allocations since the program started. SQLite allocates through malloc() and is not counted.
+static std::atomic<uint64_t> allocationCount(0u);
+
+// Receives the results of the benchmarks so that the compiler cannot remove the measured calls.
+static volatile int64_t sink = 0;
+
+void* operator new(size_t size)
+{
+    ++allocationCount;
+    void* memoryPtr = std::malloc((size == 0u) ? 1u : size);
+    if (nullptr == memoryPtr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return memoryPtr;
+}
+
+void operator delete(void* memoryPtr) noexcept
+{
+    std::free(memoryPtr);
+}
+
+void operator delete(void* memoryPtr, size_t /*size*/) noexcept
+{
+    std::free(memoryPtr);
+}
+
+/**
+ * Pass a result to the sink.
+ * @param value The result.
+ */
+static inline void Consume(int64_t value)
+{
+    // Compound assignment to a volatile object is deprecated in C++20.
+    sink = sink + value;
+}
+
+/**
+ * Run a benchmark and print one result line.
+ * @param name Name of the benchmark.
+ * @param iterations Number of times \p body is called.
+ * @param rowsPerIteration Number of rows a call of \p body processes, or zero if the benchmark does not scan rows.
+ * @param body The operation to measure.
+ */
+static void Run(const string& name, int iterations, int rowsPerIteration, const std::function<void()>& body)
+{
+    // Warm up caches and statement state.
+    for (int index = 0; index < iterations / 10 + 1; ++index)
+    {
+        body();
+    }
+
+    uint64_t allocationsBefore = allocationCount.load();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int index = 0; index < iterations; ++index)
+    {
+        body();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t allocations = allocationCount.load() - allocationsBefore;
+
+    std::printf("  %-44s %12.1f ns/op %10.2f allocs/op", name.c_str(), seconds * 1e9 / iterations, (double)allocations / iterations);
+    if (rowsPerIteration > 0)
+    {
+        std::printf(" %14.0f rows/s", (double)rowsPerIteration * iterations / seconds);
+    }
+
+    std::printf("\n");
+}
+
+/**
+ * Step processor that reads both columns of every row.
+ */
+class ScanProcessing : public StepStatementProcessing
+{
+    public:
+        int64_t sum = 0;
+
+        virtual void RowRetrieved(PreparedStatement& statement, bool& /*continueProcessing*/)
+        {
+            sum += statement.GetInt64(0) + (int64_t)statement.GetStringView(1).size();
+        }
+};
+
+/**
+ * sqlite3_exec() processor that counts rows.
+ */
+class CountingRows : public RowProcessor
+{
+    public:
+        int64_t rows = 0;
+
+        virtual bool RowData(const std::vector< std::pair<string, string> >& /*values*/)
+        {
+            ++rows;
+            return true;
+        }
+
+        virtual bool RowData(const std::vector<string>& /*values*/)
+        {
+            ++rows;
+            return true;
+        }
+};
+
+/**
+ * Typed streaming processor that reads both columns of every row.
+ */
+class ScanStream : public StreamProcessor
+{
+    public:
+        int64_t sum = 0;
+
+        virtual bool RowData(const ResultRow& row)
+        {
+            sum += row.GetInt64(0) + (int64_t)row.GetStringView(1).size();
+            return true;
+        }
+};
+
+static int RawExecCallback(void* userData, int /*numFields*/, char** /*fieldValues*/, char** /*fieldNames*/)
+{
+    ++*(int64_t*)userData;
+    return 0;
+}
+
+static void PrepareBenchmarks(SQLite& db, sqlite3* rawDb, int iterations)
+{
+    const string sql("SELECT id, name FROM items WHERE id = ?");
+
+    Run("prepare+finalize raw", iterations, 0, [&]()
+    {
+        sqlite3_stmt* statementPtr = nullptr;
+        sqlite3_prepare_v2(rawDb, sql.c_str(), (int)sql.size() + 1, &statementPtr, nullptr);
+        sqlite3_finalize(statementPtr);
+    });
+
+    Run("prepare+finalize prepared_statement", iterations, 0, [&]()
+    {
+        PreparedStatement statement(db, sql);
+    });
+
+    Run("PrepareCached lease", iterations, 0, [&]()
+    {
+        db.PrepareCached(sql);
+    });
+}
+
+static void BindBenchmarks(SQLite& db, sqlite3* rawDb, int iterations)
+{
+    const string sql("SELECT ?");
+    const string text(64u, 't');
+    const std::wstring wideText(64u, L'w');
+    const vector<uint8_t> blob(4096u, 0x5a);
+
+    sqlite3_stmt* rawPtr = nullptr;
+    sqlite3_prepare_v2(rawDb, sql.c_str(), (int)sql.size() + 1, &rawPtr, nullptr);
+    PreparedStatement statement(db, sql);
+
+    Run("bind int raw", iterations, 0, [&]() { sqlite3_bind_int(rawPtr, 1, 42); });
+    Run("Bind(int)", iterations, 0, [&]() { statement.Bind(1, 42); });
+    Run("bind int64 raw", iterations, 0, [&]() { sqlite3_bind_int64(rawPtr, 1, 42); });
+    Run("Bind(int64_t)", iterations, 0, [&]() { statement.Bind(1, (int64_t)42); });
+    Run("bind double raw", iterations, 0, [&]() { sqlite3_bind_double(rawPtr, 1, 4.2); });
+    Run("Bind(double)", iterations, 0, [&]() { statement.Bind(1, 4.2); });
+    Run("bind null raw", iterations, 0, [&]() { sqlite3_bind_null(rawPtr, 1); });
+    Run("Bind() null", iterations, 0, [&]() { statement.Bind(1); });
+    Run("bind text transient raw", iterations, 0, [&]() { sqlite3_bind_text64(rawPtr, 1, text.c_str(), text.size(), SQLITE_TRANSIENT, SQLITE_UTF8); });
+    Run("Bind(const std::string&)", iterations, 0, [&]() { statement.Bind(1, text); });
+    Run("Bind(std::string&&)", iterations, 0, [&]() { statement.Bind(1, string(text)); });
+    Run("bind text static raw", iterations, 0, [&]() { sqlite3_bind_text64(rawPtr, 1, text.c_str(), text.size(), SQLITE_STATIC, SQLITE_UTF8); });
+    Run("BindStatic(text_view)", iterations, 0, [&]() { statement.BindStatic(1, TextView(text.data(), text.size())); });
+    Run("bind text16 transient raw", iterations, 0, [&]() { sqlite3_bind_text16(rawPtr, 1, wideText.c_str(), (int)(wideText.size() * sizeof(wchar_t)), SQLITE_TRANSIENT); });
+    Run("Bind(const std::wstring&)", iterations, 0, [&]() { statement.Bind(1, wideText); });
+    Run("bind blob transient raw", iterations, 0, [&]() { sqlite3_bind_blob64(rawPtr, 1, blob.data(), blob.size(), SQLITE_TRANSIENT); });
+    Run("Bind(const std::vector<uint8_t>&)", iterations, 0, [&]() { statement.Bind(1, blob); });
+    Run("Bind(std::vector<uint8_t>&&)", iterations, 0, [&]() { statement.Bind(1, vector<uint8_t>(blob)); });
+    Run("bind blob static raw", iterations, 0, [&]() { sqlite3_bind_blob64(rawPtr, 1, blob.data(), blob.size(), SQLITE_STATIC); });
+    Run("BindStatic(blob_span)", iterations, 0, [&]() { statement.BindStatic(1, BlobSpan(blob.data(), blob.size())); });
+    Run("bind zeroblob raw", iterations, 0, [&]() { sqlite3_bind_zeroblob64(rawPtr, 1, 4096u); });
+    Run("BindZeroBlob", iterations, 0, [&]() { statement.BindZeroBlob(1, 4096u); });
+
+    sqlite3_finalize(rawPtr);
+}
+
+static void GetBenchmarks(SQLite& db, sqlite3* rawDb, int iterations)
+{
+    const string sql("SELECT 42, 4.2, 'some text value of moderate length', x'000102030405060708090a0b0c0d0e0f'");
+
+    sqlite3_stmt* rawPtr = nullptr;
+    sqlite3_prepare_v2(rawDb, sql.c_str(), (int)sql.size() + 1, &rawPtr, nullptr);
+    sqlite3_step(rawPtr);
+
+    PreparedStatement statement(db, sql);
+    ResultRow row(nullptr);
+    for (const ResultRow& current : statement.Rows())
+    {
+        // Keep the statement positioned on its only row.
+        row = current;
+        break;
+    }
+
+    Run("column_int raw", iterations, 0, [&]() { Consume(sqlite3_column_int(rawPtr, 0)); });
+    Run("GetInt", iterations, 0, [&]() { Consume(statement.GetInt(0)); });
+    Run("column_int64 raw", iterations, 0, [&]() { Consume(sqlite3_column_int64(rawPtr, 0)); });
+    Run("GetInt64", iterations, 0, [&]() { Consume(statement.GetInt64(0)); });
+    Run("column_double raw", iterations, 0, [&]() { Consume((int64_t)sqlite3_column_double(rawPtr, 1)); });
+    Run("GetDouble", iterations, 0, [&]() { Consume((int64_t)statement.GetDouble(1)); });
+    Run("column_text+bytes raw", iterations, 0, [&]() { Consume((int64_t)(size_t)sqlite3_column_text(rawPtr, 2) + sqlite3_column_bytes(rawPtr, 2)); });
+    Run("GetString", iterations, 0, [&]() { Consume((int64_t)statement.GetString(2).size()); });
+    Run("GetStringView", iterations, 0, [&]() { Consume((int64_t)statement.GetStringView(2).size()); });
+    Run("result_row::GetStringView", iterations, 0, [&]() { Consume((int64_t)row.GetStringView(2).size()); });
+    Run("column_text16+bytes16 raw", iterations, 0, [&]() { Consume((int64_t)(size_t)sqlite3_column_text16(rawPtr, 2) + sqlite3_column_bytes16(rawPtr, 2)); });
+    Run("GetWString", iterations, 0, [&]() { Consume((int64_t)statement.GetWString(2).size()); });
+    Run("column_blob+bytes raw", iterations, 0, [&]() { Consume((int64_t)(size_t)sqlite3_column_blob(rawPtr, 3) + sqlite3_column_bytes(rawPtr, 3)); });
+    Run("GetBlob", iterations, 0, [&]() { Consume((int64_t)statement.GetBlob(3).size()); });
+    Run("GetBlobSpan", iterations, 0, [&]() { Consume((int64_t)statement.GetBlobSpan(3).size()); });
+    Run("column_type raw", iterations, 0, [&]() { Consume(sqlite3_column_type(rawPtr, 0)); });
+    Run("GetColumnType", iterations, 0, [&]() { Consume((int64_t)statement.GetColumnType(0)); });
+
+    sqlite3_finalize(rawPtr);
+}
+
+static void ScanBenchmarks(SQLite& db, sqlite3* rawDb, int iterations)
+{
+    const string sql("SELECT id, name FROM items");
+
+    sqlite3_stmt* rawPtr = nullptr;
+    sqlite3_prepare_v2(rawDb, sql.c_str(), (int)sql.size() + 1, &rawPtr, nullptr);
+    PreparedStatement statement(db, sql);
+
+    Run("scan step loop raw", iterations, ScanRows, [&]()
+    {
+        int64_t sum = 0;
+        while (sqlite3_step(rawPtr) == SQLITE_ROW)
+        {
+            const unsigned char* textPtr = sqlite3_column_text(rawPtr, 1);
+            sum += sqlite3_column_int64(rawPtr, 0) + sqlite3_column_bytes(rawPtr, 1) + (textPtr != nullptr ? 0 : 1);
+        }
+
+        sqlite3_reset(rawPtr);
+        Consume(sum);
+    });
+
+    Run("scan Step(StepStatementProcessing&)", iterations, ScanRows, [&]()
+    {
+        ScanProcessing processor;
+        statement.Step(processor);
+        statement.Reset();
+        Consume(processor.sum);
+    });
+
+    Run("scan Rows()", iterations, ScanRows, [&]()
+    {
+        int64_t sum = 0;
+        for (const ResultRow& row : statement.Rows())
+        {
+            sum += row.GetInt64(0) + (int64_t)row.GetStringView(1).size();
+        }
+
+        statement.Reset();
+        Consume(sum);
+    });
+
+    sqlite3_finalize(rawPtr);
+
+    Run("sqlite3_exec raw", iterations, ScanRows, [&]()
+    {
+        int64_t rows = 0;
+        sqlite3_exec(rawDb, sql.c_str(), RawExecCallback, &rows, nullptr);
+        Consume(rows);
+    });
+
+    Run("Exec(sql, exec_result&)", iterations, ScanRows, [&]()
+    {
+        CountingRows processor;
+        db.Exec(sql, processor);
+        Consume(processor.rows);
+    });
+
+    Run("Exec(sql, exec_stream&)", iterations, ScanRows, [&]()
+    {
+        ScanStream processor;
+        db.Exec(sql, processor);
+        Consume(processor.sum);
+    });
+}
+
+/**
+ * Run all benchmarks on one database.
+ * @param title Title of the result section.
+ * @param dbPath Path of the database, or ":memory:".
+ * @param iterations Number of iterations of the per-call benchmarks.
+ */
+static void RunAll(const string& title, const string& dbPath, int iterations)
+{
+    SQLite db(dbPath);
+    db.Exec("DROP TABLE IF EXISTS items; CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT)");
+    db.Exec("BEGIN");
+    {
+        PreparedStatement insert(db, "INSERT INTO items (id, name) VALUES (?, ?)");
+        for (int id = 0; id < ScanRows; ++id)
+        {
+            insert.Bind(1, id);
+            insert.Bind(2, "item name " + std::to_string(id));
+            insert.Execute();
+            insert.Reset();
+        }
+    }
+    db.Exec("COMMIT");
+
+    sqlite3* rawDb = nullptr;
+    sqlite3_open_v2(dbPath.c_str(), &rawDb, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+    if (dbPath == ":memory:")
+    {
+        // A second in-memory connection would see an empty database.
+        sqlite3_exec(rawDb, "CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT);"
+            "WITH RECURSIVE n(id) AS (SELECT 0 UNION ALL SELECT id + 1 FROM n WHERE id + 1 < 10000) "
+            "INSERT INTO items SELECT id, 'item name ' || id FROM n", nullptr, nullptr, nullptr);
+    }
+
+    std::printf("%s\n", title.c_str());
+    PrepareBenchmarks(db, rawDb, iterations);
+    BindBenchmarks(db, rawDb, iterations);
+    GetBenchmarks(db, rawDb, iterations);
+    ScanBenchmarks(db, rawDb, iterations / 1000 + 1);
+
+    sqlite3_close_v2(rawDb);
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = (argc > 1) ? std::atoi(argv[1]) : 100000;
+    if (iterations <= 0)
+    {
+        std::fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+        return 1;
+    }
+
+    const string dbPath("wrapper_benchmark.db");
+
+    try
+    {
+        RunAll("in-memory database", ":memory:", iterations);
+        RunAll("file database", dbPath, iterations);
+    }
+    catch (const sqlitelib::sqlite_exception& ex)
+    {
+        std::fprintf(stderr, "sqlite_exception %d: %s\n", ex.GetReturnCode(), ex.what());
+        std::remove(dbPath.c_str());
+        return 1;
+    }
+
+    std::remove(dbPath.c_str());
+    return 0;
+}
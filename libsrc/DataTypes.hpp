@@ -33,7 +33,7 @@ namespace sqlitelib
     #ifdef _WIN32
         using STRING = std::wstring;
         #define ROUTINE_NAME __FUNCSIG__
-    #elif __gnu_linux
+    #elif defined(__gnu_linux__) || defined(__gnu_linux)
         using STRING = std::string;
         #define ROUTINE_NAME __PRETTY_FUNCTION__
     #endif
@@ -0,0 +1,123 @@
+#include "async_executor.hpp"
+#include "statement_cache.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::function;
+        using std::string;
+
+        async_executor::async_executor(STRING dbFilePath, size_t workerCount, size_t queueCapacity, int flags)
+            :   _connections(),
+                _workers(),
+                _queue(),
+                _queueCapacity((queueCapacity == 0u) ? 1u : queueCapacity),
+                _stopping(false),
+                _mutex(),
+                _jobQueued(),
+                _jobTaken()
+        {
+            if (workerCount == 0u)
+            {
+                throw sqlite_exception(SQLITE_MISUSE, "An async_executor needs at least one worker");
+            }
+
+            // The connections are opened up front so that open errors are reported to the caller.
+            this->_connections.reserve(workerCount);
+            for (size_t index = 0u; index < workerCount; ++index)
+            {
+                this->_connections.emplace_back(new sqlite(dbFilePath, flags));
+            }
+
+            this->_workers.reserve(workerCount);
+            for (size_t index = 0u; index < workerCount; ++index)
+            {
+                sqlite* connectionPtr = this->_connections[index].get();
+                this->_workers.emplace_back([this, connectionPtr]() { this->WorkerLoop(*connectionPtr); });
+            }
+        }
+
+        async_executor::~async_executor()
+        {
+            {
+                std::lock_guard<std::mutex> lock(this->_mutex);
+                this->_stopping = true;
+            }
+
+            this->_jobQueued.notify_all();
+            for (std::thread& worker : this->_workers)
+            {
+                worker.join();
+            }
+        }
+
+        std::future<void> async_executor::Query(const string& sql, function<void(prepared_statement&)> bind, function<bool(const result_row&)> rowSink)
+        {
+            return this->Submit([sql, bind, rowSink](sqlite& connection)
+            {
+                cached_statement statement = connection.PrepareCached(sql);
+                if (bind)
+                {
+                    bind(*statement);
+                }
+
+                for (const result_row& row : statement->Rows())
+                {
+                    if (!rowSink(row))
+                    {
+                        break;
+                    }
+                }
+            });
+        }
+
+        size_t async_executor::QueueSize()
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            return this->_queue.size();
+        }
+
+        void async_executor::Enqueue(job&& function)
+        {
+            {
+                std::unique_lock<std::mutex> lock(this->_mutex);
+                this->_jobTaken.wait(lock, [this]() { return this->_queue.size() < this->_queueCapacity; });
+                this->_queue.push_back(std::move(function));
+            }
+
+            this->_jobQueued.notify_one();
+        }
+
+        void async_executor::WorkerLoop(sqlite& connection)
+        {
+            for (;;)
+            {
+                job current;
+                {
+                    std::unique_lock<std::mutex> lock(this->_mutex);
+                    this->_jobQueued.wait(lock, [this]() { return this->_stopping || !this->_queue.empty(); });
+                    if (this->_queue.empty())
+                    {
+                        // Stopping, and all queued jobs have been taken.
+                        return;
+                    }
+
+                    current = std::move(this->_queue.front());
+                    this->_queue.pop_front();
+                }
+
+                this->_jobTaken.notify_one();
+
+                try
+                {
+                    current(connection);
+                }
+                catch (...)
+                {
+                    // Jobs report their errors through their future or completion callback.
+                }
+            }
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
@@ -0,0 +1,167 @@
+#if !defined ASYNC_EXECUTOR_BB0AB32CCFEF460D816674433F5C255D
+#define ASYNC_EXECUTOR_BB0AB32CCFEF460D816674433F5C255D
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "DataTypes.hpp"
+#include "prepared_statement.hpp"
+#include "row_iterator.hpp"
+#include "sqlite.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Result type of a job that is called with a \c sqlite&.
+         */
+        template <typename Function> struct async_job_result
+        {
+            #if defined(__cpp_lib_is_invocable) && (__cpp_lib_is_invocable >= 201703L)
+                using type = typename std::invoke_result<Function, sqlite&>::type;
+            #else
+                using type = decltype(std::declval<Function>()(std::declval<sqlite&>()));
+            #endif // __cpp_lib_is_invocable
+        }; // struct async_job_result
+
+        /**
+         * @brief Runs database work on worker threads that each own a connection to the same database.
+         * @details Jobs are queued in a bounded queue. Submitting a job blocks while the queue is full, which applies
+         * backpressure to the submitting threads. Jobs receive the connection of the worker that runs them and may use
+         * its statement cache. The destructor runs all queued jobs before it joins the workers.
+         */
+        class async_executor
+        {
+            private:
+                using job = std::function<void(sqlite&)>;
+
+            private:
+                std::vector< std::unique_ptr<sqlite> > _connections;    ///< One connection per worker.
+                std::vector<std::thread> _workers;                      ///< The worker threads.
+                std::deque<job> _queue;                                 ///< Jobs that have not started yet.
+                size_t _queueCapacity;                                  ///< Maximum number of queued jobs.
+                bool _stopping;                                         ///< Flag that is set by the destructor.
+                std::mutex _mutex;                                      ///< Protects the queue and the stop flag.
+                std::condition_variable _jobQueued;                     ///< Signalled when a job is queued or the executor stops.
+                std::condition_variable _jobTaken;                      ///< Signalled when a job is taken from the queue.
+
+            public:
+                /**
+                 * @brief Open the connections and start the workers.
+                 * @param dbFilePath String object containing the path to the database file.
+                 * @param workerCount Number of worker threads. Must not be zero.
+                 * @param queueCapacity Maximum number of jobs that wait for a worker.
+                 * @param flags File open flags of the worker connections.
+                 */
+                async_executor(STRING dbFilePath, size_t workerCount, size_t queueCapacity, int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX);
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                async_executor(const async_executor& src) = delete;
+
+                /**
+                 * @brief Destructor. Runs the queued jobs and stops the workers.
+                 */
+                ~async_executor();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                async_executor& operator=(const async_executor& src) = delete;
+
+            public:
+                /**
+                 * @brief Queue a job. Blocks while the queue is full.
+                 * @param function Callable object that takes a \c sqlite& and returns the result of the job.
+                 * @returns Returns a future that receives the result, or the exception thrown by the job.
+                 */
+                template <typename Function> std::future<typename async_job_result<Function>::type> Submit(Function&& function);
+
+                /**
+                 * @brief Queue a job and call \p completion on the worker thread when it ends. Blocks while the queue is full.
+                 * @details Both callables are moved into the job, so they may be move-only.
+                 * @param function Callable object that takes a \c sqlite&.
+                 * @param completion Callable object that takes a \c std::exception_ptr, which is empty if the job succeeded.
+                 */
+                template <typename Function, typename Completion> void Post(Function&& function, Completion&& completion);
+
+                /**
+                 * @brief Queue a query. Blocks while the queue is full.
+                 * @param sql SQL statement. It is prepared through the statement cache of the worker connection.
+                 * @param bind Callable object that binds the parameters. The values must be captured by value.
+                 * @param rowSink Callable object that is called for each row and returns \c false to stop.
+                 * @returns Returns a future that becomes ready when the query has ended.
+                 */
+                std::future<void> Query(const std::string& sql, std::function<void(prepared_statement&)> bind, std::function<bool(const result_row&)> rowSink);
+
+                /**
+                 * @brief Returns the number of jobs that wait for a worker.
+                 */
+                size_t QueueSize();
+
+            private:
+                /**
+                 * @brief Add a job to the queue. Blocks while the queue is full.
+                 * @param function The job.
+                 */
+                void Enqueue(job&& function);
+
+                /**
+                 * @brief Main loop of a worker thread.
+                 * @param connection Connection of the worker.
+                 */
+                void WorkerLoop(sqlite& connection);
+        }; // class async_executor
+
+        template <typename Function> std::future<typename async_job_result<Function>::type> async_executor::Submit(Function&& function)
+        {
+            using result_type = typename async_job_result<Function>::type;
+
+            // std::function needs a copyable target, so the move-only task is shared.
+            auto taskPtr = std::make_shared< std::packaged_task<result_type(sqlite&)> >(std::forward<Function>(function));
+            std::future<result_type> result = taskPtr->get_future();
+
+            this->Enqueue([taskPtr](sqlite& connection) { (*taskPtr)(connection); });
+            return result;
+        }
+
+        template <typename Function, typename Completion> void async_executor::Post(Function&& function, Completion&& completion)
+        {
+            using callables = std::pair<typename std::decay<Function>::type, typename std::decay<Completion>::type>;
+
+            // std::function needs a copyable target, so move-only callables are shared.
+            auto callablesPtr = std::make_shared<callables>(std::forward<Function>(function), std::forward<Completion>(completion));
+
+            this->Enqueue([callablesPtr](sqlite& connection)
+            {
+                std::exception_ptr error;
+                try
+                {
+                    callablesPtr->first(connection);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+
+                callablesPtr->second(error);
+            });
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // ASYNC_EXECUTOR_BB0AB32CCFEF460D816674433F5C255D
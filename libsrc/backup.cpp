@@ -0,0 +1,125 @@
+#include "backup.hpp"
+#include "sqlite_exception.hpp"
+#include <thread>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::string;
+
+        backup::backup(sqlite& destination, sqlite& source, const backup_options& options)
+            :   _destination(destination._dbObject),
+                _backupPtr(nullptr),
+                _options(options),
+                _progress(),
+                _pageSize(0),
+                _done(false),
+                _started(std::chrono::steady_clock::now())
+        {
+            this->_backupPtr = sqlite3_backup_init(this->_destination, options.destinationName.c_str(), source._dbObject, options.sourceName.c_str());
+            if (nullptr == this->_backupPtr)
+            {
+                throw sqlite_exception(sqlite3_errcode(this->_destination), sqlite3_errmsg(this->_destination));
+            }
+
+            // The page size is fixed while the backup runs, because the destination must use the page size of the source.
+            sqlite3_stmt* statementPtr = nullptr;
+            string sql = "PRAGMA \"" + options.sourceName + "\".page_size";
+            if (sqlite3_prepare_v2(source._dbObject, sql.c_str(), -1, &statementPtr, nullptr) == SQLITE_OK)
+            {
+                if (sqlite3_step(statementPtr) == SQLITE_ROW)
+                {
+                    this->_pageSize = sqlite3_column_int(statementPtr, 0);
+                }
+            }
+
+            sqlite3_finalize(statementPtr);
+        }
+
+        backup::~backup()
+        {
+            sqlite3_backup_finish(this->_backupPtr);
+            this->_backupPtr = nullptr;
+        }
+
+        bool backup::Step()
+        {
+            if (this->_done)
+            {
+                return true;
+            }
+
+            int remainingBefore = (this->_progress.steps == 0u) ? -1 : sqlite3_backup_remaining(this->_backupPtr);
+            int rc = sqlite3_backup_step(this->_backupPtr, this->_options.pagesPerStep);
+
+            ++this->_progress.steps;
+            this->_progress.remainingPages = sqlite3_backup_remaining(this->_backupPtr);
+            this->_progress.pageCount = sqlite3_backup_pagecount(this->_backupPtr);
+            this->_progress.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->_started).count();
+
+            switch (rc)
+            {
+                case SQLITE_OK:
+                case SQLITE_DONE:
+                {
+                    // A change of the source by another connection restarts the backup, which makes the remaining
+                    // count grow.
+                    int copied = remainingBefore - this->_progress.remainingPages;
+                    if ((remainingBefore < 0) || (copied < 0))
+                    {
+                        copied = this->_progress.pageCount - this->_progress.remainingPages;
+                    }
+
+                    this->_progress.bytesCopied += (uint64_t)copied * (uint64_t)this->_pageSize;
+                    this->_done = (rc == SQLITE_DONE);
+                    return this->_done;
+                }
+
+                case SQLITE_BUSY:
+                case SQLITE_LOCKED:
+                {
+                    ++this->_progress.busySteps;
+                    return false;
+                }
+
+                default:
+                {
+                    throw sqlite_exception(rc, sqlite3_errmsg(this->_destination));
+                }
+            }
+        }
+
+        backup_progress backup::Run(std::function<bool(const backup_progress&)> progress)
+        {
+            while (!this->Step())
+            {
+                if (progress && !progress(this->_progress))
+                {
+                    return this->_progress;
+                }
+
+                if (this->_options.sleepMilliseconds > 0)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(this->_options.sleepMilliseconds));
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+
+            if (progress)
+            {
+                progress(this->_progress);
+            }
+
+            return this->_progress;
+        }
+
+        backup_progress backup::Progress() const
+        {
+            return this->_progress;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
@@ -0,0 +1,146 @@
+#if !defined BACKUP_BB0AB32CCFEF460D816674433F5C255D
+#define BACKUP_BB0AB32CCFEF460D816674433F5C255D
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <sqlite3.h>
+#include "sqlite.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Settings for a backup.
+         */
+        struct backup_options
+        {
+            int pagesPerStep;           ///< Number of pages copied by each step. A negative value copies all pages in one step.
+            int sleepMilliseconds;      ///< Pause between two steps of Run(), during which other connections can write. Zero yields the thread instead.
+            std::string sourceName;     ///< Name of the source database, e.g. \c "main".
+            std::string destinationName; ///< Name of the destination database.
+
+            /**
+             * @brief Construct the default settings: copy 256 pages per step, pause 1 ms between steps, and copy the
+             * main database into the main database.
+             */
+            inline backup_options();
+        }; // struct backup_options
+
+        /**
+         * @brief Progress of a backup.
+         */
+        struct backup_progress
+        {
+            int remainingPages;     ///< Number of pages that still have to be copied.
+            int pageCount;          ///< Number of pages of the source database.
+            uint64_t steps;         ///< Number of steps run.
+            uint64_t busySteps;     ///< Number of steps that could not copy because the source or destination was locked.
+            uint64_t bytesCopied;   ///< Number of bytes copied by the steps, counting pages that were copied again after a change of the source.
+            double seconds;         ///< Time since the backup was started.
+
+            /**
+             * @brief Get the copy rate.
+             * @returns Returns the number of bytes copied per second.
+             */
+            inline double BytesPerSecond() const;
+        }; // struct backup_progress
+
+        /**
+         * @brief Online backup of a database into another connection, through \c sqlite3_backup_init().
+         * @details Pages are copied in steps. The source is only locked while a step runs, so writers on other
+         * connections can proceed between steps; if they change the source, the backup starts over automatically.
+         * Changes made through the source connection itself are copied into the backup.
+         */
+        class backup
+        {
+            private:
+                sqlite3* _destination;                              ///< Connection that receives the copy.
+                sqlite3_backup* _backupPtr;                         ///< Handle of the backup.
+                backup_options _options;                            ///< Settings of the backup.
+                backup_progress _progress;                          ///< Progress of the backup.
+                int _pageSize;                                      ///< Page size of the source database in bytes.
+                bool _done;                                         ///< Flag that is set when all pages have been copied.
+                std::chrono::steady_clock::time_point _started;     ///< Time at which the backup was started.
+
+            public:
+                /**
+                 * @brief Start a backup.
+                 * @param destination Connection that receives the copy. It must not be used while the backup runs.
+                 * @param source Connection of the database to copy.
+                 * @param options Settings of the backup.
+                 */
+                backup(sqlite& destination, sqlite& source, const backup_options& options = backup_options());
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                backup(const backup& src) = delete;
+
+                /**
+                 * @brief Destructor. Releases the backup handle; an unfinished backup is abandoned.
+                 */
+                ~backup();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                backup& operator=(const backup& src) = delete;
+
+            public:
+                /**
+                 * @brief Copy the next batch of pages. A locked source or destination is not an error; the step is
+                 * counted in \c busySteps and can be retried.
+                 * @retval true All pages have been copied.
+                 * @retval false Pages remain to be copied.
+                 */
+                bool Step();
+
+                /**
+                 * @brief Run steps until all pages have been copied, pausing between the steps.
+                 * @param progress Callable object that is called after each step. It returns \c false to stop the
+                 * backup early, which leaves it unfinished. Pass an empty function for no callback.
+                 * @returns Returns the progress after the last step.
+                 */
+                backup_progress Run(std::function<bool(const backup_progress&)> progress = std::function<bool(const backup_progress&)>());
+
+                /**
+                 * @brief Get the progress of the backup.
+                 * @returns Returns a snapshot of the progress.
+                 */
+                backup_progress Progress() const;
+
+                /**
+                 * @brief Check if all pages have been copied.
+                 * @retval true The backup is complete.
+                 * @retval false Pages remain to be copied.
+                 */
+                inline bool Done() const;
+        }; // class backup
+
+        inline backup_options::backup_options()
+            :   pagesPerStep(256),
+                sleepMilliseconds(1),
+                sourceName("main"),
+                destinationName("main")
+        {
+        }
+
+        inline double backup_progress::BytesPerSecond() const
+        {
+            return (this->seconds > 0.0) ? (double)this->bytesCopied / this->seconds : 0.0;
+        }
+
+        inline bool backup::Done() const
+        {
+            return this->_done;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // BACKUP_BB0AB32CCFEF460D816674433F5C255D
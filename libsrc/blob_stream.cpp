@@ -0,0 +1,313 @@
+#include "blob_stream.hpp"
+#include "sqlite_exception.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::string;
+
+        blob_stream::blob_stream(sqlite& dbObject, const string& table, const string& column, int64_t rowId, bool writable, const string& dbName)
+            :   _dbObject(dbObject._dbObject),
+                _blobPtr(nullptr)
+        {
+            int rc = sqlite3_blob_open(this->_dbObject, dbName.c_str(), table.c_str(), column.c_str(), (sqlite3_int64)rowId, writable ? 1 : 0, &this->_blobPtr);
+            if (rc != SQLITE_OK)
+            {
+                // A handle is returned on some errors and must be closed.
+                sqlite3_blob_close(this->_blobPtr);
+                this->_blobPtr = nullptr;
+                this->ThrowError(rc);
+            }
+        }
+
+        blob_stream::blob_stream(blob_stream&& src)
+            :   _dbObject(src._dbObject),
+                _blobPtr(src._blobPtr)
+        {
+            src._blobPtr = nullptr;
+        }
+
+        blob_stream::~blob_stream()
+        {
+            if (this->_blobPtr != nullptr)
+            {
+                sqlite3_blob_close(this->_blobPtr);
+                this->_blobPtr = nullptr;
+            }
+        }
+
+        size_t blob_stream::Size()
+        {
+            return (size_t)sqlite3_blob_bytes(this->_blobPtr);
+        }
+
+        size_t blob_stream::Read(void* buffer, size_t count, size_t offset)
+        {
+            size_t size = this->Size();
+            if (offset >= size)
+            {
+                return 0u;
+            }
+
+            count = std::min(count, size - offset);
+            int rc = sqlite3_blob_read(this->_blobPtr, buffer, (int)count, (int)offset);
+            if (rc != SQLITE_OK)
+            {
+                this->ThrowError(rc);
+            }
+
+            return count;
+        }
+
+        void blob_stream::Write(const void* buffer, size_t count, size_t offset)
+        {
+            if ((count > (size_t)INT_MAX) || (offset > (size_t)INT_MAX))
+            {
+                throw sqlite_exception(SQLITE_TOOBIG);
+            }
+
+            int rc = sqlite3_blob_write(this->_blobPtr, buffer, (int)count, (int)offset);
+            if (rc != SQLITE_OK)
+            {
+                this->ThrowError(rc);
+            }
+        }
+
+        void blob_stream::Reopen(int64_t rowId)
+        {
+            int rc = sqlite3_blob_reopen(this->_blobPtr, (sqlite3_int64)rowId);
+            if (rc != SQLITE_OK)
+            {
+                this->ThrowError(rc);
+            }
+        }
+
+        void blob_stream::ThrowError(int rc)
+        {
+            throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+        }
+
+        blob_streambuf::blob_streambuf(blob_stream& blob, size_t bufferSize)
+            :   _blob(blob),
+                _buffer(new char[(bufferSize == 0u) ? 1u : bufferSize]),
+                _bufferSize((bufferSize == 0u) ? 1u : bufferSize),
+                _position(0u),
+                _size(blob.Size())
+        {
+        }
+
+        blob_streambuf::~blob_streambuf()
+        {
+            this->FlushPutArea();
+        }
+
+        void blob_streambuf::Reopen(int64_t rowId)
+        {
+            // Unlike the virtual functions, which report errors as end of file, errors are thrown here.
+            size_t count = (size_t)(this->pptr() - this->pbase());
+            if (count > 0u)
+            {
+                this->_blob.Write(this->pbase(), count, this->_position);
+            }
+
+            this->setg(nullptr, nullptr, nullptr);
+            this->setp(nullptr, nullptr);
+
+            this->_blob.Reopen(rowId);
+            this->_position = 0u;
+            this->_size = this->_blob.Size();
+        }
+
+        blob_streambuf::int_type blob_streambuf::underflow()
+        {
+            if (this->gptr() < this->egptr())
+            {
+                return traits_type::to_int_type(*this->gptr());
+            }
+
+            if (!this->Settle() || (this->_position >= this->_size))
+            {
+                return traits_type::eof();
+            }
+
+            size_t count;
+            try
+            {
+                count = this->_blob.Read(this->_buffer.get(), this->_bufferSize, this->_position);
+            }
+            catch (const sqlite_exception&)
+            {
+                return traits_type::eof();
+            }
+
+            this->setg(this->_buffer.get(), this->_buffer.get(), this->_buffer.get() + count);
+            return traits_type::to_int_type(*this->gptr());
+        }
+
+        blob_streambuf::int_type blob_streambuf::overflow(int_type character)
+        {
+            if (!this->Settle())
+            {
+                return traits_type::eof();
+            }
+
+            if (traits_type::eq_int_type(character, traits_type::eof()))
+            {
+                return traits_type::not_eof(character);
+            }
+
+            // The put area ends at the end of the BLOB, because the BLOB cannot grow.
+            size_t available = std::min(this->_bufferSize, this->_size - std::min(this->_position, this->_size));
+            if (available == 0u)
+            {
+                return traits_type::eof();
+            }
+
+            this->setp(this->_buffer.get(), this->_buffer.get() + available);
+            *this->pptr() = traits_type::to_char_type(character);
+            this->pbump(1);
+            return character;
+        }
+
+        int blob_streambuf::sync()
+        {
+            return this->FlushPutArea() ? 0 : -1;
+        }
+
+        std::streamsize blob_streambuf::xsgetn(char* buffer, std::streamsize count)
+        {
+            std::streamsize result = 0;
+
+            // Data that is already buffered.
+            std::streamsize buffered = std::min(count, (std::streamsize)(this->egptr() - this->gptr()));
+            if (buffered > 0)
+            {
+                std::memcpy(buffer, this->gptr(), (size_t)buffered);
+                this->gbump((int)buffered);
+                result = buffered;
+            }
+
+            if ((count - result) < (std::streamsize)this->_bufferSize)
+            {
+                return result + std::streambuf::xsgetn(buffer + result, count - result);
+            }
+
+            // Large reads go straight into the caller's buffer.
+            if (!this->Settle())
+            {
+                return result;
+            }
+
+            try
+            {
+                size_t read = this->_blob.Read(buffer + result, (size_t)(count - result), this->_position);
+                this->_position += read;
+                result += (std::streamsize)read;
+            }
+            catch (const sqlite_exception&)
+            {
+            }
+
+            return result;
+        }
+
+        std::streamsize blob_streambuf::xsputn(const char* buffer, std::streamsize count)
+        {
+            if (count < (std::streamsize)this->_bufferSize)
+            {
+                return std::streambuf::xsputn(buffer, count);
+            }
+
+            // Large writes go straight from the caller's buffer into the BLOB.
+            if (!this->Settle())
+            {
+                return 0;
+            }
+
+            size_t available = this->_size - std::min(this->_position, this->_size);
+            size_t written = std::min((size_t)count, available);
+            try
+            {
+                this->_blob.Write(buffer, written, this->_position);
+            }
+            catch (const sqlite_exception&)
+            {
+                return 0;
+            }
+
+            this->_position += written;
+            return (std::streamsize)written;
+        }
+
+        blob_streambuf::pos_type blob_streambuf::seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode /*which*/)
+        {
+            if (!this->Settle())
+            {
+                return pos_type(off_type(-1));
+            }
+
+            off_type base = 0;
+            if (direction == std::ios_base::cur)
+            {
+                base = (off_type)this->_position;
+            }
+            else if (direction == std::ios_base::end)
+            {
+                base = (off_type)this->_size;
+            }
+
+            off_type target = base + offset;
+            if ((target < 0) || (target > (off_type)this->_size))
+            {
+                return pos_type(off_type(-1));
+            }
+
+            this->_position = (size_t)target;
+            return pos_type(target);
+        }
+
+        blob_streambuf::pos_type blob_streambuf::seekpos(pos_type position, std::ios_base::openmode which)
+        {
+            return this->seekoff(off_type(position), std::ios_base::beg, which);
+        }
+
+        bool blob_streambuf::FlushPutArea()
+        {
+            size_t count = (size_t)(this->pptr() - this->pbase());
+            if (count == 0u)
+            {
+                return true;
+            }
+
+            try
+            {
+                this->_blob.Write(this->pbase(), count, this->_position);
+            }
+            catch (const sqlite_exception&)
+            {
+                return false;
+            }
+
+            this->_position += count;
+            this->setp(this->_buffer.get(), this->_buffer.get());
+            return true;
+        }
+
+        bool blob_streambuf::Settle()
+        {
+            if (this->eback() != nullptr)
+            {
+                this->_position += (size_t)(this->gptr() - this->eback());
+                this->setg(nullptr, nullptr, nullptr);
+            }
+
+            bool result = this->FlushPutArea();
+            this->setp(nullptr, nullptr);
+            return result;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
@@ -0,0 +1,176 @@
+#if !defined BLOB_STREAM_BB0AB32CCFEF460D816674433F5C255D
+#define BLOB_STREAM_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstdint>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <sqlite3.h>
+#include "sqlite.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Incremental access to a BLOB through \c sqlite3_blob_open(), without loading the BLOB into memory.
+         * @details The size of the BLOB cannot be changed through the handle. To store a large BLOB, insert a
+         * \c zeroblob() of the final size, for example with prepared_statement::BindZeroBlob(), and write the data in
+         * chunks. The handle becomes invalid when the row is changed or deleted by another statement.
+         */
+        class blob_stream
+        {
+            private:
+                sqlite3* _dbObject;     ///< Connection that owns the BLOB.
+                sqlite3_blob* _blobPtr; ///< Handle of the open BLOB.
+
+            public:
+                /**
+                 * @brief Open a BLOB.
+                 * @param dbObject Reference to a \c sqlite object.
+                 * @param table Name of the table.
+                 * @param column Name of the column.
+                 * @param rowId Row id of the row.
+                 * @param writable Flag that is set to open the BLOB for writing.
+                 * @param dbName Name of the database that contains the table.
+                 */
+                blob_stream(sqlite& dbObject, const std::string& table, const std::string& column, int64_t rowId, bool writable = false, const std::string& dbName = "main");
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                blob_stream(const blob_stream& src) = delete;
+
+                /**
+                 * @brief Move constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                blob_stream(blob_stream&& src);
+
+                /**
+                 * @brief Destructor. Closes the BLOB.
+                 */
+                ~blob_stream();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                blob_stream& operator=(const blob_stream& src) = delete;
+
+            public:
+                /**
+                 * @brief Returns the size of the BLOB in bytes.
+                 */
+                size_t Size();
+
+                /**
+                 * @brief Read a chunk of the BLOB into a buffer of the caller.
+                 * @param buffer Buffer that receives the data.
+                 * @param count Number of bytes to read.
+                 * @param offset Offset of the first byte to read.
+                 * @returns Returns the number of bytes read, which is less than \p count at the end of the BLOB.
+                 */
+                size_t Read(void* buffer, size_t count, size_t offset);
+
+                /**
+                 * @brief Write a chunk of the BLOB.
+                 * @param buffer The data.
+                 * @param count Number of bytes to write. The chunk must end within the BLOB.
+                 * @param offset Offset of the first byte to write.
+                 */
+                void Write(const void* buffer, size_t count, size_t offset);
+
+                /**
+                 * @brief Move the handle to the BLOB of another row of the same table and column. This is faster than
+                 * opening a new handle.
+                 * @param rowId Row id of the row.
+                 */
+                void Reopen(int64_t rowId);
+
+            private:
+                /**
+                 * @brief Throw an exception for a failed call.
+                 * @param rc Result code of the call.
+                 */
+                void ThrowError(int rc);
+        }; // class blob_stream
+
+        /**
+         * @brief Stream buffer over a blob_stream, for use with \c std::istream and \c std::ostream.
+         * @details Data is transferred in chunks of the buffer size. Reads and writes that are larger than the buffer
+         * go directly between the caller's memory and the BLOB. Writing past the end of the BLOB fails, because the
+         * size of the BLOB cannot be changed.
+         */
+        class blob_streambuf : public std::streambuf
+        {
+            private:
+                blob_stream& _blob;                 ///< The BLOB.
+                std::unique_ptr<char[]> _buffer;    ///< Buffer for the get or the put area.
+                size_t _bufferSize;                 ///< Size of the buffer.
+                size_t _position;                   ///< Offset in the BLOB of the start of the get or put area.
+                size_t _size;                       ///< Size of the BLOB.
+
+            public:
+                /**
+                 * @brief Construct a stream buffer that starts at the beginning of the BLOB.
+                 * @param blob The BLOB, which must outlive the stream buffer.
+                 * @param bufferSize Size of the chunks that are read from or written to the BLOB.
+                 */
+                explicit blob_streambuf(blob_stream& blob, size_t bufferSize = 65536u);
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                blob_streambuf(const blob_streambuf& src) = delete;
+
+                /**
+                 * @brief Destructor. Writes buffered data to the BLOB.
+                 */
+                virtual ~blob_streambuf();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                blob_streambuf& operator=(const blob_streambuf& src) = delete;
+
+            public:
+                /**
+                 * @brief Write buffered data, move the BLOB handle to another row and start at the beginning of its BLOB.
+                 * @param rowId Row id of the row.
+                 */
+                void Reopen(int64_t rowId);
+
+            protected:
+                virtual int_type underflow();
+                virtual int_type overflow(int_type character);
+                virtual int sync();
+                virtual std::streamsize xsgetn(char* buffer, std::streamsize count);
+                virtual std::streamsize xsputn(const char* buffer, std::streamsize count);
+                virtual pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which);
+                virtual pos_type seekpos(pos_type position, std::ios_base::openmode which);
+
+            private:
+                /**
+                 * @brief Write the put area to the BLOB and move \c _position behind it.
+                 * @retval true The data was written.
+                 * @retval false Writing failed.
+                 */
+                bool FlushPutArea();
+
+                /**
+                 * @brief Move \c _position to the current read or write position and empty the get and put areas.
+                 * @retval true The put area was written.
+                 * @retval false Writing failed.
+                 */
+                bool Settle();
+        }; // class blob_streambuf
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // BLOB_STREAM_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,297 @@
+#include "bulk_inserter.hpp"
+#include <cstring>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::string;
+        using std::vector;
+        using std::wstring;
+
+        /**
+         * @brief Build an \c INSERT statement with one parameter per column.
+         * @param table Name of the table.
+         * @param columns Names of the columns.
+         * @returns Returns the SQL statement.
+         */
+        static string InsertSql(const string& table, const vector<string>& columns)
+        {
+            string sql("INSERT INTO ");
+            sql.append(table).append(" (");
+
+            for (size_t index = 0u; index < columns.size(); ++index)
+            {
+                sql.append((index == 0u) ? "" : ", ").append(columns[index]);
+            }
+
+            sql.append(") VALUES (");
+            for (size_t index = 0u; index < columns.size(); ++index)
+            {
+                sql.append((index == 0u) ? "?" : ", ?");
+            }
+
+            sql.append(")");
+            return sql;
+        }
+
+        /**
+         * @brief Step statement processor that keeps the first column of the first row.
+         */
+        class first_value_processing : public StepStatementProcessing
+        {
+            public:
+                string value; ///< Text of the first column of the first row.
+
+            public:
+                virtual void RowRetrieved(prepared_statement& statement, bool& continueProcessing)
+                {
+                    this->value = statement.GetString(0);
+                    continueProcessing = false;
+                }
+        }; // class first_value_processing
+
+        /**
+         * @brief Get the value of a pragma.
+         * @param dbObject Reference to a \c sqlite object.
+         * @param name Name of the pragma.
+         * @returns Returns the value of the pragma as text.
+         */
+        static string PragmaValue(sqlite& dbObject, const string& name)
+        {
+            prepared_statement statement(dbObject, "PRAGMA " + name);
+            first_value_processing processor;
+            statement.Step(processor);
+            return processor.value;
+        }
+
+        bulk_inserter::bulk_inserter(sqlite& dbObject, const string& table, const vector<string>& columns, const bulk_insert_options& options)
+            :   bulk_inserter(dbObject, InsertSql(table, columns), options)
+        {
+        }
+
+        bulk_inserter::bulk_inserter(sqlite& dbObject, const string& sql, const bulk_insert_options& options)
+            :   _dbObject(dbObject),
+                _statement(dbObject, sql),
+                _parameterCount(_statement.ParametersCount()),
+                _options(options),
+                _transaction(),
+                _chunkRows(0u),
+                _chunkBytes(0u),
+                _stats(),
+                _started(std::chrono::steady_clock::now()),
+                _previousSynchronous(),
+                _previousJournalMode(),
+                _finished(false)
+        {
+            try
+            {
+                this->ApplyPragmas();
+            }
+            catch (...)
+            {
+                // The destructor does not run for a failed constructor, so a pragma that was changed is restored here.
+                try
+                {
+                    this->RestorePragmas();
+                }
+                catch (...)
+                {
+                }
+
+                throw;
+            }
+        }
+
+        bulk_inserter::~bulk_inserter()
+        {
+            if (this->_finished)
+            {
+                return;
+            }
+
+            try
+            {
+                this->_transaction.reset();
+                this->RestorePragmas();
+            }
+            catch (...)
+            {
+                // Destructors must not throw.
+            }
+        }
+
+        void bulk_inserter::Commit()
+        {
+            if (this->_transaction)
+            {
+                this->_transaction->Commit();
+                this->_transaction.reset();
+                ++this->_stats.commits;
+            }
+
+            this->_chunkRows = 0u;
+            this->_chunkBytes = 0u;
+        }
+
+        bulk_insert_stats bulk_inserter::Finish()
+        {
+            if (!this->_finished)
+            {
+                this->Commit();
+                this->_statement.ClearBindings();
+                this->RestorePragmas();
+                this->_stats = this->Stats();
+                this->_finished = true;
+            }
+
+            return this->_stats;
+        }
+
+        bulk_insert_stats bulk_inserter::Stats() const
+        {
+            if (this->_finished)
+            {
+                return this->_stats;
+            }
+
+            bulk_insert_stats result(this->_stats);
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->_started).count();
+            return result;
+        }
+
+        void bulk_inserter::ApplyPragmas()
+        {
+            if (!this->_options.synchronous.empty())
+            {
+                this->_previousSynchronous = PragmaValue(this->_dbObject, "synchronous");
+                this->_dbObject.Exec("PRAGMA synchronous = " + this->_options.synchronous);
+            }
+
+            if (!this->_options.journalMode.empty())
+            {
+                this->_previousJournalMode = PragmaValue(this->_dbObject, "journal_mode");
+                this->_dbObject.Exec("PRAGMA journal_mode = " + this->_options.journalMode);
+            }
+        }
+
+        void bulk_inserter::RestorePragmas()
+        {
+            if (!this->_previousJournalMode.empty())
+            {
+                this->_dbObject.Exec("PRAGMA journal_mode = " + this->_previousJournalMode);
+                this->_previousJournalMode.clear();
+            }
+
+            if (!this->_previousSynchronous.empty())
+            {
+                this->_dbObject.Exec("PRAGMA synchronous = " + this->_previousSynchronous);
+                this->_previousSynchronous.clear();
+            }
+        }
+
+        void bulk_inserter::StepRow(size_t rowBytes)
+        {
+            if (!this->_transaction)
+            {
+                this->_transaction.reset(new transaction(this->_dbObject, transaction_mode::immediate));
+            }
+
+            try
+            {
+                this->_statement.Execute();
+            }
+            catch (...)
+            {
+                // A failed step leaves the statement unusable until it is reset. The reset reports the same error.
+                try
+                {
+                    this->_statement.Reset();
+                }
+                catch (const sqlite_exception&)
+                {
+                }
+
+                // The text and BLOB values point to memory of the caller, which may be released after this row.
+                this->_statement.ClearBindings();
+                throw;
+            }
+
+            this->_statement.Reset();
+            this->_statement.ClearBindings();
+
+            ++this->_chunkRows;
+            this->_chunkBytes += rowBytes;
+            ++this->_stats.rows;
+            this->_stats.bytes += rowBytes;
+
+            if (((this->_options.rowsPerCommit != 0u) && (this->_chunkRows >= this->_options.rowsPerCommit))
+                || ((this->_options.bytesPerCommit != 0u) && (this->_chunkBytes >= this->_options.bytesPerCommit)))
+            {
+                this->Commit();
+            }
+        }
+
+        void bulk_inserter::BindValue(int paramIndex, std::nullptr_t, size_t& /*rowBytes*/)
+        {
+            this->_statement.Bind(paramIndex);
+        }
+
+        void bulk_inserter::BindValue(int paramIndex, int value, size_t& rowBytes)
+        {
+            this->_statement.Bind(paramIndex, value);
+            rowBytes += sizeof(value);
+        }
+
+        void bulk_inserter::BindValue(int paramIndex, int64_t value, size_t& rowBytes)
+        {
+            this->_statement.Bind(paramIndex, value);
+            rowBytes += sizeof(value);
+        }
+
+        void bulk_inserter::BindValue(int paramIndex, double value, size_t& rowBytes)
+        {
+            this->_statement.Bind(paramIndex, value);
+            rowBytes += sizeof(value);
+        }
+
+        void bulk_inserter::BindValue(int paramIndex, const char* value, size_t& rowBytes)
+        {
+            if (nullptr == value)
+            {
+                this->_statement.Bind(paramIndex);
+                return;
+            }
+
+            this->BindValue(paramIndex, text_view(value, std::strlen(value)), rowBytes);
+        }
+
+        void bulk_inserter::BindValue(int paramIndex, const string& value, size_t& rowBytes)
+        {
+            this->BindValue(paramIndex, text_view(value.data(), value.size()), rowBytes);
+        }
+
+        void bulk_inserter::BindValue(int paramIndex, const wstring& value, size_t& rowBytes)
+        {
+            this->_statement.Bind(paramIndex, value);
+            rowBytes += value.size() * sizeof(value[0]);
+        }
+
+        void bulk_inserter::BindValue(int paramIndex, const vector<uint8_t>& value, size_t& rowBytes)
+        {
+            this->BindValue(paramIndex, blob_span(value.data(), value.size()), rowBytes);
+        }
+
+        void bulk_inserter::BindValue(int paramIndex, text_view value, size_t& rowBytes)
+        {
+            this->_statement.BindStatic(paramIndex, value);
+            rowBytes += value.size();
+        }
+
+        void bulk_inserter::BindValue(int paramIndex, blob_span value, size_t& rowBytes)
+        {
+            this->_statement.BindStatic(paramIndex, value);
+            rowBytes += value.size();
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
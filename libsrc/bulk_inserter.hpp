@@ -0,0 +1,252 @@
+#if !defined BULK_INSERTER_BB0AB32CCFEF460D816674433F5C255D
+#define BULK_INSERTER_BB0AB32CCFEF460D816674433F5C255D
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "prepared_statement.hpp"
+#include "sqlite_exception.hpp"
+#include "transaction.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Settings for a bulk_inserter.
+         */
+        struct bulk_insert_options
+        {
+            size_t rowsPerCommit;       ///< Commit after this many rows. Zero disables the row limit.
+            size_t bytesPerCommit;      ///< Commit after this many bytes of parameter data. Zero disables the byte limit.
+            std::string synchronous;    ///< Value for \c PRAGMA \c synchronous during the load, e.g. \c "OFF". Empty keeps the current value.
+            std::string journalMode;    ///< Value for \c PRAGMA \c journal_mode during the load, e.g. \c "MEMORY". Empty keeps the current value.
+
+            /**
+             * @brief Construct the default settings: commit every 10000 rows and leave the pragmas unchanged.
+             */
+            inline bulk_insert_options();
+        }; // struct bulk_insert_options
+
+        /**
+         * @brief Counters maintained by a bulk_inserter.
+         */
+        struct bulk_insert_stats
+        {
+            uint64_t rows;      ///< Number of rows inserted.
+            uint64_t bytes;     ///< Number of bytes of parameter data inserted.
+            uint64_t commits;   ///< Number of transactions committed.
+            double seconds;     ///< Time since the inserter was created, or the duration of the load once it is finished.
+
+            /**
+             * @brief Get the insert rate.
+             * @returns Returns the number of rows inserted per second.
+             */
+            inline double RowsPerSecond() const;
+        }; // struct bulk_insert_stats
+
+        /**
+         * @brief Inserts large numbers of rows through one prepared statement, committing in chunks.
+         * @details Text and BLOB values are bound without copying, because each row is stepped before AddRow()
+         * returns and the bindings are cleared after the step, whether it succeeded or not. The current chunk is rolled back and the pragmas are restored if the object is destroyed before
+         * Finish() is called. Each chunk runs in its own \c BEGIN \c IMMEDIATE transaction, so AddRow() fails if the
+         * caller already has a transaction open on the connection. A row that fails, for example because of a
+         * constraint, throws and leaves the chunk open; the inserter can continue with the next row.
+         */
+        class bulk_inserter
+        {
+            private:
+                sqlite& _dbObject;                          ///< Connection that receives the rows.
+                prepared_statement _statement;              ///< The \c INSERT statement.
+                int _parameterCount;                        ///< Number of parameters of the statement.
+                bulk_insert_options _options;               ///< Settings of the load.
+                std::unique_ptr<transaction> _transaction;  ///< Transaction of the current chunk.
+                size_t _chunkRows;                          ///< Number of rows in the current chunk.
+                size_t _chunkBytes;                         ///< Number of bytes in the current chunk.
+                bulk_insert_stats _stats;                   ///< Counters of the load.
+                std::chrono::steady_clock::time_point _started; ///< Time at which the inserter was created.
+                std::string _previousSynchronous;           ///< Value of \c PRAGMA \c synchronous before the load.
+                std::string _previousJournalMode;           ///< Value of \c PRAGMA \c journal_mode before the load.
+                bool _finished;                             ///< Flag that is set by Finish().
+
+            public:
+                /**
+                 * @brief Construct an inserter for a table.
+                 * @param dbObject Reference to a \c sqlite object.
+                 * @param table Name of the table.
+                 * @param columns Names of the columns that receive values, in the order in which they are passed to AddRow().
+                 * @param options Settings of the load.
+                 */
+                bulk_inserter(sqlite& dbObject, const std::string& table, const std::vector<std::string>& columns, const bulk_insert_options& options = bulk_insert_options());
+
+                /**
+                 * @brief Construct an inserter for an \c INSERT statement.
+                 * @param dbObject Reference to a \c sqlite object.
+                 * @param sql \c INSERT statement with one parameter per value.
+                 * @param options Settings of the load.
+                 */
+                bulk_inserter(sqlite& dbObject, const std::string& sql, const bulk_insert_options& options = bulk_insert_options());
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                bulk_inserter(const bulk_inserter& src) = delete;
+
+                /**
+                 * @brief Destructor. Rolls back the current chunk and restores the pragmas if Finish() was not called.
+                 */
+                ~bulk_inserter();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                bulk_inserter& operator=(const bulk_inserter& src) = delete;
+
+            public:
+                /**
+                 * @brief Insert one row.
+                 * @param values One value per parameter. Supported types are \c nullptr, \c int, \c int64_t, \c double,
+                 * \c const \c char*, \c std::string, \c std::wstring, \c std::vector<uint8_t>, \c text_view and \c blob_span.
+                 * A \c const \c char* that is \c nullptr is inserted as \c NULL.
+                 * @throws sqlite_exception \c SQLITE_MISUSE if the number of values differs from the number of parameters.
+                 */
+                template <typename... Values> void AddRow(const Values&... values);
+
+                /**
+                 * @brief Insert one row.
+                 * @param row Tuple with one value per parameter.
+                 */
+                template <typename... Values> void AddRow(const std::tuple<Values...>& row);
+
+                /**
+                 * @brief Insert a batch of rows that is stored column by column.
+                 * @param columns One vector per parameter. All vectors must have the same length.
+                 */
+                template <typename... Values> void AddColumns(const std::vector<Values>&... columns);
+
+                /**
+                 * @brief Commit the current chunk.
+                 */
+                void Commit();
+
+                /**
+                 * @brief Commit the last chunk and restore the pragmas.
+                 * @returns Returns the counters of the load.
+                 */
+                bulk_insert_stats Finish();
+
+                /**
+                 * @brief Get the counters of the load so far.
+                 * @returns Returns a snapshot of the counters.
+                 */
+                bulk_insert_stats Stats() const;
+
+            private:
+                /**
+                 * @brief Read the current pragmas and apply the values from the options.
+                 */
+                void ApplyPragmas();
+
+                /**
+                 * @brief Restore the pragmas that were changed by ApplyPragmas().
+                 */
+                void RestorePragmas();
+
+                /**
+                 * @brief Run the statement for the bound row and commit if a limit is reached.
+                 * @param rowBytes Number of bytes of parameter data in the row.
+                 */
+                void StepRow(size_t rowBytes);
+
+                /**
+                 * @brief Insert the elements of a tuple as one row.
+                 * @param row Tuple with one value per parameter.
+                 */
+                template <typename Tuple, size_t... Indexes> void AddTuple(const Tuple& row, std::index_sequence<Indexes...>);
+
+                /**
+                 * @brief Bind one value of a row. Text and BLOB values are bound without copying.
+                 * @param paramIndex Index of the parameter. The left-most parameter has index 1.
+                 * @param value Parameter value.
+                 * @param rowBytes Byte count of the row, which is incremented by the size of the value.
+                 */
+                void BindValue(int paramIndex, std::nullptr_t, size_t& rowBytes);
+                void BindValue(int paramIndex, int value, size_t& rowBytes);
+                void BindValue(int paramIndex, int64_t value, size_t& rowBytes);
+                void BindValue(int paramIndex, double value, size_t& rowBytes);
+                void BindValue(int paramIndex, const char* value, size_t& rowBytes);
+                void BindValue(int paramIndex, const std::string& value, size_t& rowBytes);
+                void BindValue(int paramIndex, const std::wstring& value, size_t& rowBytes);
+                void BindValue(int paramIndex, const std::vector<uint8_t>& value, size_t& rowBytes);
+                void BindValue(int paramIndex, text_view value, size_t& rowBytes);
+                void BindValue(int paramIndex, blob_span value, size_t& rowBytes);
+        }; // class bulk_inserter
+
+        inline bulk_insert_options::bulk_insert_options()
+            :   rowsPerCommit(10000u),
+                bytesPerCommit(0u),
+                synchronous(),
+                journalMode()
+        {
+        }
+
+        inline double bulk_insert_stats::RowsPerSecond() const
+        {
+            return (this->seconds > 0.0) ? ((double)this->rows / this->seconds) : 0.0;
+        }
+
+        template <typename... Values> void bulk_inserter::AddRow(const Values&... values)
+        {
+            if ((int)sizeof...(Values) != this->_parameterCount)
+            {
+                throw sqlite_exception(SQLITE_MISUSE, "The number of values does not match the number of parameters of the INSERT statement.");
+            }
+
+            int paramIndex = 0;
+            size_t rowBytes = 0u;
+
+            // Braced initializers are evaluated from left to right, so the parameters are bound in order.
+            int expansion[] = { 0, (this->BindValue(++paramIndex, values, rowBytes), 0)... };
+            (void)expansion;
+
+            this->StepRow(rowBytes);
+        }
+
+        template <typename... Values> void bulk_inserter::AddRow(const std::tuple<Values...>& row)
+        {
+            this->AddTuple(row, std::index_sequence_for<Values...>());
+        }
+
+        template <typename Tuple, size_t... Indexes> void bulk_inserter::AddTuple(const Tuple& row, std::index_sequence<Indexes...>)
+        {
+            this->AddRow(std::get<Indexes>(row)...);
+        }
+
+        template <typename... Values> void bulk_inserter::AddColumns(const std::vector<Values>&... columns)
+        {
+            const size_t columnLengths[] = { columns.size()... };
+            for (size_t length : columnLengths)
+            {
+                if (length != columnLengths[0])
+                {
+                    throw sqlite_exception(SQLITE_MISUSE, "Column batches must have the same length.");
+                }
+            }
+
+            for (size_t row = 0u; row < columnLengths[0]; ++row)
+            {
+                this->AddRow(columns[row]...);
+            }
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // BULK_INSERTER_BB0AB32CCFEF460D816674433F5C255D
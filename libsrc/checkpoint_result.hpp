@@ -0,0 +1,34 @@
+#if !defined CHECKPOINT_RESULT_BB0AB32CCFEF460D816674433F5C255D
+#define CHECKPOINT_RESULT_BB0AB32CCFEF460D816674433F5C255D
+
+#include <sqlite3.h>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Mode of a WAL checkpoint, see \c sqlite3_wal_checkpoint_v2().
+         */
+        enum class checkpoint_mode
+        {
+            passive = SQLITE_CHECKPOINT_PASSIVE,    ///< Copy as many frames as possible without waiting for readers or writers.
+            full = SQLITE_CHECKPOINT_FULL,          ///< Wait for writers, then copy all frames.
+            restart = SQLITE_CHECKPOINT_RESTART,    ///< Like \c full, then wait for readers so that the WAL file is reused from its start.
+            truncate = SQLITE_CHECKPOINT_TRUNCATE   ///< Like \c restart, then truncate the WAL file to zero bytes.
+        }; // enum class checkpoint_mode
+
+        /**
+         * @brief Outcome of a WAL checkpoint.
+         */
+        struct checkpoint_result
+        {
+            int logFrames;          ///< Number of frames in the WAL file, or -1 if the database is not in WAL mode.
+            int checkpointedFrames; ///< Number of frames that have been copied into the database file, or -1 if the database is not in WAL mode.
+            bool busy;              ///< Flag that is set if the checkpoint could not complete because of other connections.
+            double seconds;         ///< Time spent in the checkpoint.
+        }; // struct checkpoint_result
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // CHECKPOINT_RESULT_BB0AB32CCFEF460D816674433F5C255D
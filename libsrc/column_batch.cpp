@@ -0,0 +1,113 @@
+#include "column_batch.hpp"
+#include "sqlite_exception.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::vector;
+
+        column_batch::column_batch(const vector<batch_column_type>& types, size_t capacity, size_t arenaBytesPerRow)
+            :   _columns(types.size()),
+                _capacity(capacity),
+                _rowCount(0u),
+                _endOfResult(false)
+        {
+            if (capacity == 0u)
+            {
+                throw sqlite_exception(SQLITE_MISUSE, "A column_batch needs a capacity of at least one row");
+            }
+
+            for (size_t index = 0u; index < types.size(); ++index)
+            {
+                column& target = this->_columns[index];
+                target.type = types[index];
+                target.nulls.resize((capacity + 63u) / 64u);
+
+                switch (target.type)
+                {
+                    case batch_column_type::int64:
+                        target.integers.resize(capacity);
+                        break;
+
+                    case batch_column_type::floating_point:
+                        target.doubles.resize(capacity);
+                        break;
+
+                    case batch_column_type::text:
+                    case batch_column_type::blob:
+                        target.arena.resize(capacity * arenaBytesPerRow);
+                        target.offsets.resize(capacity + 1u);
+                        break;
+                }
+            }
+        }
+
+        void column_batch::Clear()
+        {
+            this->_rowCount = 0u;
+            this->_endOfResult = false;
+
+            for (column& target : this->_columns)
+            {
+                std::fill(target.nulls.begin(), target.nulls.end(), (uint64_t)0u);
+            }
+        }
+
+        void column_batch::StoreRow(sqlite3_stmt* statementPtr)
+        {
+            const size_t row = this->_rowCount;
+
+            for (size_t index = 0u; index < this->_columns.size(); ++index)
+            {
+                column& target = this->_columns[index];
+                int columnIndex = (int)index;
+
+                if (sqlite3_column_type(statementPtr, columnIndex) == SQLITE_NULL)
+                {
+                    target.nulls[row / 64u] |= ((uint64_t)1u << (row % 64u));
+                }
+
+                switch (target.type)
+                {
+                    case batch_column_type::int64:
+                        target.integers[row] = (int64_t)sqlite3_column_int64(statementPtr, columnIndex);
+                        break;
+
+                    case batch_column_type::floating_point:
+                        target.doubles[row] = sqlite3_column_double(statementPtr, columnIndex);
+                        break;
+
+                    case batch_column_type::text:
+                    case batch_column_type::blob:
+                        {
+                            // The pointer must be fetched before the size, because sqlite3_column_text() may convert the value.
+                            const void* dataPtr = (target.type == batch_column_type::text)
+                                ? (const void*)sqlite3_column_text(statementPtr, columnIndex)
+                                : sqlite3_column_blob(statementPtr, columnIndex);
+                            size_t length = (size_t)sqlite3_column_bytes(statementPtr, columnIndex);
+
+                            size_t start = (row == 0u) ? 0u : target.offsets[row];
+                            if (start + length > target.arena.size())
+                            {
+                                target.arena.resize(std::max(target.arena.size() * 2u, start + length));
+                            }
+
+                            if (length != 0u)
+                            {
+                                std::memcpy(target.arena.data() + start, dataPtr, length);
+                            }
+
+                            target.offsets[row] = start;
+                            target.offsets[row + 1u] = start + length;
+                        }
+                        break;
+                }
+            }
+
+            ++this->_rowCount;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
@@ -0,0 +1,197 @@
+#if !defined COLUMN_BATCH_BB0AB32CCFEF460D816674433F5C255D
+#define COLUMN_BATCH_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <sqlite3.h>
+#include "column_view.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        class prepared_statement;
+
+        /**
+         * @brief Storage type of a column in a column_batch.
+         */
+        enum class batch_column_type
+        {
+            int64 = 0,      ///< Values are stored in a \c std::vector<int64_t>.
+            floating_point, ///< Values are stored in a \c std::vector<double>.
+            text,           ///< UTF-8 values are stored back to back in a byte arena.
+            blob            ///< BLOB values are stored back to back in a byte arena.
+        }; // enum class batch_column_type
+
+        /**
+         * @brief Struct-of-arrays buffer that receives up to Capacity() rows from prepared_statement::FetchBatch().
+         * @details All storage is allocated when the batch is constructed and reused for every batch, except that a text
+         * arena grows when a batch holds more text than any batch before it. \c NULL values are recorded in a bitmap per
+         * column, and stored as zero or as an empty value.
+         */
+        class column_batch
+        {
+            friend class prepared_statement;
+
+            private:
+                /**
+                 * @brief Storage of one column.
+                 */
+                struct column
+                {
+                    batch_column_type type;         ///< Storage type of the column.
+                    std::vector<int64_t> integers;  ///< Values of an \c int64 column.
+                    std::vector<double> doubles;    ///< Values of a \c floating_point column.
+                    std::vector<uint8_t> arena;     ///< Bytes of a \c text or \c blob column.
+                    std::vector<size_t> offsets;    ///< Start of each value in \c arena, plus the end of the last value.
+                    std::vector<uint64_t> nulls;    ///< Bit \c row is set if the value in \c row is \c NULL.
+                };
+
+            private:
+                std::vector<column> _columns;   ///< Storage of the columns.
+                size_t _capacity;               ///< Maximum number of rows in a batch.
+                size_t _rowCount;               ///< Number of rows in the current batch.
+                bool _endOfResult;              ///< Flag that is set when the statement has no more rows.
+
+            public:
+                /**
+                 * @brief Construct a batch.
+                 * @param types Storage type of each result column.
+                 * @param capacity Maximum number of rows in a batch. Must not be zero.
+                 * @param arenaBytesPerRow Expected size of a \c text or \c blob value, used to size the arenas.
+                 */
+                column_batch(const std::vector<batch_column_type>& types, size_t capacity, size_t arenaBytesPerRow = 32u);
+
+            public:
+                /**
+                 * @brief Returns the maximum number of rows in a batch.
+                 */
+                inline size_t Capacity() const;
+
+                /**
+                 * @brief Returns the number of rows in the current batch.
+                 */
+                inline size_t RowCount() const;
+
+                /**
+                 * @brief Returns the number of columns.
+                 */
+                inline int ColumnsCount() const;
+
+                /**
+                 * @brief Check if the statement returned its last row.
+                 * @retval true The statement has no more rows.
+                 * @retval false More rows may follow in the next batch.
+                 */
+                inline bool EndOfResult() const;
+
+                /**
+                 * @brief Get the values of an \c int64 column. Only the first RowCount() elements are valid.
+                 * @param index Column index.
+                 */
+                inline const std::vector<int64_t>& Int64Column(int index) const;
+
+                /**
+                 * @brief Get the values of a \c floating_point column. Only the first RowCount() elements are valid.
+                 * @param index Column index.
+                 */
+                inline const std::vector<double>& DoubleColumn(int index) const;
+
+                /**
+                 * @brief Get a value of a \c text column.
+                 * @param index Column index.
+                 * @param row Row index within the batch.
+                 * @returns Returns a view on the arena that is valid until the next batch is fetched.
+                 */
+                inline text_view TextValue(int index, size_t row) const;
+
+                /**
+                 * @brief Get a value of a \c blob column.
+                 * @param index Column index.
+                 * @param row Row index within the batch.
+                 * @returns Returns a view on the arena that is valid until the next batch is fetched.
+                 */
+                inline blob_span BlobValue(int index, size_t row) const;
+
+                /**
+                 * @brief Check if a value is \c NULL.
+                 * @param index Column index.
+                 * @param row Row index within the batch.
+                 */
+                inline bool IsNull(int index, size_t row) const;
+
+                /**
+                 * @brief Get the \c NULL bitmap of a column. Bit \c row of word \c row/64 is set for a \c NULL value.
+                 * @param index Column index.
+                 */
+                inline const std::vector<uint64_t>& NullBitmap(int index) const;
+
+            private:
+                /**
+                 * @brief Start a new batch.
+                 */
+                void Clear();
+
+                /**
+                 * @brief Copy the current row of a statement into the batch.
+                 * @param statementPtr Handle of the prepared statement.
+                 */
+                void StoreRow(sqlite3_stmt* statementPtr);
+        }; // class column_batch
+
+        inline size_t column_batch::Capacity() const
+        {
+            return this->_capacity;
+        }
+
+        inline size_t column_batch::RowCount() const
+        {
+            return this->_rowCount;
+        }
+
+        inline int column_batch::ColumnsCount() const
+        {
+            return (int)this->_columns.size();
+        }
+
+        inline bool column_batch::EndOfResult() const
+        {
+            return this->_endOfResult;
+        }
+
+        inline const std::vector<int64_t>& column_batch::Int64Column(int index) const
+        {
+            return this->_columns[(size_t)index].integers;
+        }
+
+        inline const std::vector<double>& column_batch::DoubleColumn(int index) const
+        {
+            return this->_columns[(size_t)index].doubles;
+        }
+
+        inline text_view column_batch::TextValue(int index, size_t row) const
+        {
+            const column& source = this->_columns[(size_t)index];
+            return text_view((const char*)source.arena.data() + source.offsets[row], source.offsets[row + 1u] - source.offsets[row]);
+        }
+
+        inline blob_span column_batch::BlobValue(int index, size_t row) const
+        {
+            const column& source = this->_columns[(size_t)index];
+            return blob_span(source.arena.data() + source.offsets[row], source.offsets[row + 1u] - source.offsets[row]);
+        }
+
+        inline bool column_batch::IsNull(int index, size_t row) const
+        {
+            return (this->_columns[(size_t)index].nulls[row / 64u] & ((uint64_t)1u << (row % 64u))) != 0u;
+        }
+
+        inline const std::vector<uint64_t>& column_batch::NullBitmap(int index) const
+        {
+            return this->_columns[(size_t)index].nulls;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // COLUMN_BATCH_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,144 @@
+#if !defined COLUMN_VIEW_BB0AB32CCFEF460D816674433F5C255D
+#define COLUMN_VIEW_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Non-owning view on a contiguous sequence of elements, such as a column value in SQLite's buffer.
+         * @details The view does not copy the data. For column values the data remains valid until the next call to
+         * Step() or Reset() on the statement, or until the column is read again with a different encoding.
+         */
+        template <typename T> class column_view
+        {
+            private:
+                const T* _data; ///< First element of the sequence.
+                size_t _size;   ///< Number of elements in the sequence.
+
+            public:
+                /**
+                 * @brief Construct an empty view.
+                 */
+                inline column_view();
+
+                /**
+                 * @brief Construct a view on a sequence.
+                 * @param data First element of the sequence.
+                 * @param size Number of elements in the sequence.
+                 */
+                inline column_view(const T* data, size_t size);
+
+            public:
+                /**
+                 * @brief Get a pointer to the first element.
+                 * @returns Returns a pointer to the first element, or \c nullptr for a \c NULL column value.
+                 */
+                inline const T* data() const;
+
+                /**
+                 * @brief Get the number of elements.
+                 * @returns Returns the number of elements in the view.
+                 */
+                inline size_t size() const;
+
+                /**
+                 * @brief Check if the view is empty.
+                 * @retval true The view contains no elements.
+                 * @retval false The view contains at least one element.
+                 */
+                inline bool empty() const;
+
+                /**
+                 * @brief Get an iterator to the first element.
+                 */
+                inline const T* begin() const;
+
+                /**
+                 * @brief Get an iterator past the last element.
+                 */
+                inline const T* end() const;
+
+                /**
+                 * @brief Access an element.
+                 * @param index Zero-based index of the element.
+                 */
+                inline const T& operator[](size_t index) const;
+
+                /**
+                 * @brief Copy the elements into a string object.
+                 * @returns Returns a string that owns a copy of the elements.
+                 */
+                inline std::basic_string<T> ToString() const;
+
+                /**
+                 * @brief Copy the elements into a vector object.
+                 * @returns Returns a vector that owns a copy of the elements.
+                 */
+                inline std::vector<T> ToVector() const;
+        }; // class column_view
+
+        using text_view = column_view<char>;        ///< View on a UTF-8 text value.
+        using u16text_view = column_view<char16_t>; ///< View on a UTF-16 text value.
+        using blob_span = column_view<uint8_t>;     ///< View on a BLOB value.
+
+        template <typename T> inline column_view<T>::column_view()
+            :   _data(nullptr),
+                _size(0u)
+        {
+        }
+
+        template <typename T> inline column_view<T>::column_view(const T* data, size_t size)
+            :   _data(data),
+                _size(size)
+        {
+        }
+
+        template <typename T> inline const T* column_view<T>::data() const
+        {
+            return this->_data;
+        }
+
+        template <typename T> inline size_t column_view<T>::size() const
+        {
+            return this->_size;
+        }
+
+        template <typename T> inline bool column_view<T>::empty() const
+        {
+            return this->_size == 0u;
+        }
+
+        template <typename T> inline const T* column_view<T>::begin() const
+        {
+            return this->_data;
+        }
+
+        template <typename T> inline const T* column_view<T>::end() const
+        {
+            return this->_data + this->_size;
+        }
+
+        template <typename T> inline const T& column_view<T>::operator[](size_t index) const
+        {
+            return this->_data[index];
+        }
+
+        template <typename T> inline std::basic_string<T> column_view<T>::ToString() const
+        {
+            return (this->_size == 0u) ? std::basic_string<T>() : std::basic_string<T>(this->_data, this->_size);
+        }
+
+        template <typename T> inline std::vector<T> column_view<T>::ToVector() const
+        {
+            return std::vector<T>(this->begin(), this->end());
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // COLUMN_VIEW_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,185 @@
+#include "connection_pool.hpp"
+#include "prepared_statement.hpp"
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::string;
+        using std::chrono::steady_clock;
+
+        pooled_connection::pooled_connection(connection_pool* poolPtr, sqlite* connectionPtr, bool writer)
+            :   _poolPtr(poolPtr),
+                _connectionPtr(connectionPtr),
+                _writer(writer)
+        {
+        }
+
+        pooled_connection::pooled_connection(pooled_connection&& src)
+            :   _poolPtr(src._poolPtr),
+                _connectionPtr(src._connectionPtr),
+                _writer(src._writer)
+        {
+            src._connectionPtr = nullptr;
+        }
+
+        pooled_connection::~pooled_connection()
+        {
+            this->Release();
+        }
+
+        pooled_connection& pooled_connection::operator=(pooled_connection&& src)
+        {
+            if (this != &src)
+            {
+                this->Release();
+                this->_poolPtr = src._poolPtr;
+                this->_connectionPtr = src._connectionPtr;
+                this->_writer = src._writer;
+                src._connectionPtr = nullptr;
+            }
+
+            return *this;
+        }
+
+        void pooled_connection::Release()
+        {
+            if (nullptr != this->_connectionPtr)
+            {
+                this->_poolPtr->Return(this->_connectionPtr, this->_writer);
+                this->_connectionPtr = nullptr;
+            }
+        }
+
+        connection_pool::connection_pool(STRING dbFilePath, size_t readerCount, int busyTimeoutMilliseconds)
+            :   _writer(),
+                _readers(),
+                _idleReaders(),
+                _writerIdle(true),
+                _mutex(),
+                _readerReturned(),
+                _writerReturned(),
+                _stats()
+        {
+            if (readerCount == 0u)
+            {
+                throw sqlite_exception(SQLITE_MISUSE, "A connection_pool needs at least one reader connection");
+            }
+
+            string busyTimeout = "PRAGMA busy_timeout = " + std::to_string(busyTimeoutMilliseconds);
+
+            // The writer is opened first so that the database file exists and is in WAL mode before the readers open it.
+            this->_writer.reset(new sqlite(dbFilePath, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX));
+            this->_writer->Exec(busyTimeout);
+
+            // SQLite keeps the old journal mode instead of failing, so the mode it reports is checked.
+            string journalMode;
+            {
+                prepared_statement statement(*this->_writer, "PRAGMA journal_mode = WAL");
+                for (const result_row& row : statement.Rows())
+                {
+                    journalMode = row.GetString(0);
+                }
+            }
+
+            if (journalMode != "wal")
+            {
+                throw sqlite_exception(SQLITE_ERROR, "The database could not be switched to WAL mode, the journal mode is " + journalMode);
+            }
+
+            this->_readers.reserve(readerCount);
+            this->_idleReaders.reserve(readerCount);
+            for (size_t index = 0u; index < readerCount; ++index)
+            {
+                this->_readers.emplace_back(new sqlite(dbFilePath, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX));
+                this->_readers.back()->Exec(busyTimeout);
+                this->_idleReaders.push_back(this->_readers.back().get());
+            }
+
+            this->_stats.readerCount = readerCount;
+        }
+
+        connection_pool::~connection_pool()
+        {
+        }
+
+        pooled_connection connection_pool::Reader()
+        {
+            std::unique_lock<std::mutex> lock(this->_mutex);
+
+            if (this->_idleReaders.empty())
+            {
+                steady_clock::time_point waitStart = steady_clock::now();
+                this->_readerReturned.wait(lock, [this]() { return !this->_idleReaders.empty(); });
+
+                double waitSeconds = std::chrono::duration<double>(steady_clock::now() - waitStart).count();
+                ++this->_stats.readerWaits;
+                this->_stats.readerWaitSeconds += waitSeconds;
+                this->_stats.maxReaderWaitSeconds = std::max(this->_stats.maxReaderWaitSeconds, waitSeconds);
+            }
+
+            sqlite* connectionPtr = this->_idleReaders.back();
+            this->_idleReaders.pop_back();
+            ++this->_stats.readerCheckouts;
+
+            return pooled_connection(this, connectionPtr, false);
+        }
+
+        pooled_connection connection_pool::Writer()
+        {
+            std::unique_lock<std::mutex> lock(this->_mutex);
+
+            if (!this->_writerIdle)
+            {
+                steady_clock::time_point waitStart = steady_clock::now();
+                this->_writerReturned.wait(lock, [this]() { return this->_writerIdle; });
+
+                double waitSeconds = std::chrono::duration<double>(steady_clock::now() - waitStart).count();
+                ++this->_stats.writerWaits;
+                this->_stats.writerWaitSeconds += waitSeconds;
+                this->_stats.maxWriterWaitSeconds = std::max(this->_stats.maxWriterWaitSeconds, waitSeconds);
+            }
+
+            this->_writerIdle = false;
+            ++this->_stats.writerCheckouts;
+
+            return pooled_connection(this, this->_writer.get(), true);
+        }
+
+        connection_pool_stats connection_pool::Stats()
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+
+            connection_pool_stats result(this->_stats);
+            result.idleReaders = this->_idleReaders.size();
+            return result;
+        }
+
+        void connection_pool::Return(sqlite* connectionPtr, bool writer)
+        {
+            {
+                std::lock_guard<std::mutex> lock(this->_mutex);
+                if (writer)
+                {
+                    this->_writerIdle = true;
+                }
+                else
+                {
+                    this->_idleReaders.push_back(connectionPtr);
+                }
+            }
+
+            if (writer)
+            {
+                this->_writerReturned.notify_one();
+            }
+            else
+            {
+                this->_readerReturned.notify_one();
+            }
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
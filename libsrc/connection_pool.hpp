@@ -0,0 +1,195 @@
+#if !defined CONNECTION_POOL_BB0AB32CCFEF460D816674433F5C255D
+#define CONNECTION_POOL_BB0AB32CCFEF460D816674433F5C255D
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "DataTypes.hpp"
+#include "sqlite.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        class connection_pool;
+
+        /**
+         * @brief Counters maintained by a connection_pool.
+         */
+        struct connection_pool_stats
+        {
+            uint64_t readerCheckouts;       ///< Number of reader connections handed out.
+            uint64_t writerCheckouts;       ///< Number of times the writer connection was handed out.
+            uint64_t readerWaits;           ///< Number of reader checkouts that had to wait for a connection.
+            uint64_t writerWaits;           ///< Number of writer checkouts that had to wait for the connection.
+            double readerWaitSeconds;       ///< Total time spent waiting for reader connections.
+            double writerWaitSeconds;       ///< Total time spent waiting for the writer connection.
+            double maxReaderWaitSeconds;    ///< Longest wait for a reader connection.
+            double maxWriterWaitSeconds;    ///< Longest wait for the writer connection.
+            size_t idleReaders;             ///< Number of reader connections that are currently not checked out.
+            size_t readerCount;             ///< Number of reader connections in the pool.
+        }; // struct connection_pool_stats
+
+        /**
+         * @brief Lease on a connection taken from a connection_pool. The connection is returned to the pool when the
+         * lease is destroyed. A lease must not outlive the pool it was obtained from.
+         */
+        class pooled_connection
+        {
+            friend class connection_pool;
+
+            private:
+                connection_pool* _poolPtr;  ///< Pool that receives the connection on release.
+                sqlite* _connectionPtr;     ///< The leased connection.
+                bool _writer;               ///< Flag that is set if the lease is on the writer connection.
+
+            private:
+                /**
+                 * @brief Construct a lease.
+                 * @param poolPtr Pool that receives the connection on release.
+                 * @param connectionPtr The leased connection.
+                 * @param writer Flag that is set if the lease is on the writer connection.
+                 */
+                pooled_connection(connection_pool* poolPtr, sqlite* connectionPtr, bool writer);
+
+            public:
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                pooled_connection(const pooled_connection& src) = delete;
+
+                /**
+                 * @brief Move constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                pooled_connection(pooled_connection&& src);
+
+                /**
+                 * @brief Destructor. Returns the connection to the pool.
+                 */
+                ~pooled_connection();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                pooled_connection& operator=(const pooled_connection& src) = delete;
+
+                /**
+                 * @brief Move assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                pooled_connection& operator=(pooled_connection&& src);
+
+                /**
+                 * @brief Access the leased connection.
+                 */
+                inline sqlite& operator*() const;
+
+                /**
+                 * @brief Access the leased connection.
+                 */
+                inline sqlite* operator->() const;
+
+                /**
+                 * @brief Return the connection to the pool before the lease goes out of scope.
+                 */
+                void Release();
+        }; // class pooled_connection
+
+        /**
+         * @brief Pool of read-only connections plus one writer connection on the same database file.
+         * @details The database is switched to WAL mode, so readers do not block the writer and the writer does not
+         * block readers. The constructor throws if the database cannot use WAL mode, for example because it is in
+         * memory or another connection holds it in exclusive locking mode. Each connection keeps its own statement
+         * cache. The connections are opened with \c SQLITE_OPEN_NOMUTEX, because a connection is only used by the
+         * thread that holds its lease.
+         */
+        class connection_pool
+        {
+            friend class pooled_connection;
+
+            private:
+                std::unique_ptr<sqlite> _writer;                    ///< The writer connection.
+                std::vector< std::unique_ptr<sqlite> > _readers;    ///< All reader connections.
+                std::vector<sqlite*> _idleReaders;                  ///< Reader connections that are not checked out.
+                bool _writerIdle;                                   ///< Set while the writer is not checked out.
+                std::mutex _mutex;                                  ///< Protects the idle lists and the counters.
+                std::condition_variable _readerReturned;            ///< Signalled when a reader is returned.
+                std::condition_variable _writerReturned;            ///< Signalled when the writer is returned.
+                connection_pool_stats _stats;                       ///< Counters of the pool.
+
+            public:
+                /**
+                 * @brief Open the connections of the pool.
+                 * @param dbFilePath String object containing the path to the database file.
+                 * @param readerCount Number of read-only connections, typically the number of worker threads. Must not
+                 * be zero.
+                 * @param busyTimeoutMilliseconds Time that a connection waits for a lock held by another process, such
+                 * as a checkpoint or a writer outside the pool, before it fails with \c SQLITE_BUSY.
+                 */
+                connection_pool(STRING dbFilePath, size_t readerCount, int busyTimeoutMilliseconds = 5000);
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                connection_pool(const connection_pool& src) = delete;
+
+                /**
+                 * @brief Destructor. No leases may be outstanding.
+                 */
+                ~connection_pool();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                connection_pool& operator=(const connection_pool& src) = delete;
+
+            public:
+                /**
+                 * @brief Check out a read-only connection. Waits until one is available.
+                 * @returns Returns a lease on the connection.
+                 */
+                pooled_connection Reader();
+
+                /**
+                 * @brief Check out the writer connection. Waits until it is available.
+                 * @returns Returns a lease on the connection.
+                 */
+                pooled_connection Writer();
+
+                /**
+                 * @brief Get the counters of the pool.
+                 * @returns Returns a snapshot of the counters.
+                 */
+                connection_pool_stats Stats();
+
+            private:
+                /**
+                 * @brief Called by pooled_connection to hand a connection back.
+                 * @param connectionPtr The connection that is returned.
+                 * @param writer Flag that is set if the connection is the writer connection.
+                 */
+                void Return(sqlite* connectionPtr, bool writer);
+        }; // class connection_pool
+
+        inline sqlite& pooled_connection::operator*() const
+        {
+            return *this->_connectionPtr;
+        }
+
+        inline sqlite* pooled_connection::operator->() const
+        {
+            return this->_connectionPtr;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // CONNECTION_POOL_BB0AB32CCFEF460D816674433F5C255D
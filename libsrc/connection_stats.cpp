@@ -0,0 +1,125 @@
+#include "connection_stats.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        static status_value DbStatus(sqlite3* dbObject, int operation, bool reset)
+        {
+            int current = 0;
+            int highwater = 0;
+            status_value result = { 0, 0 };
+
+            if (sqlite3_db_status(dbObject, operation, &current, &highwater, reset ? 1 : 0) == SQLITE_OK)
+            {
+                result.current = current;
+                result.highwater = highwater;
+            }
+
+            return result;
+        }
+
+        static status_value GlobalStatus(int operation)
+        {
+            sqlite3_int64 current = 0;
+            sqlite3_int64 highwater = 0;
+            status_value result = { 0, 0 };
+
+            if (sqlite3_status64(operation, &current, &highwater, 0) == SQLITE_OK)
+            {
+                result.current = current;
+                result.highwater = highwater;
+            }
+
+            return result;
+        }
+
+        static status_value Difference(const status_value& later, const status_value& earlier)
+        {
+            status_value result = { later.current - earlier.current, later.highwater - earlier.highwater };
+            return result;
+        }
+
+        connection_stats::connection_stats()
+        {
+            status_value zero = { 0, 0 };
+            this->lookasideUsed = zero;
+            this->lookasideHit = zero;
+            this->lookasideMissSize = zero;
+            this->lookasideMissFull = zero;
+            this->cacheUsed = zero;
+            this->cacheUsedShared = zero;
+            this->cacheHit = zero;
+            this->cacheMiss = zero;
+            this->cacheWrite = zero;
+            this->cacheSpill = zero;
+            this->schemaUsed = zero;
+            this->statementUsed = zero;
+            this->deferredForeignKeys = zero;
+            this->memoryUsed = zero;
+            this->mallocSize = zero;
+            this->mallocCount = zero;
+            this->pageCacheUsed = zero;
+            this->pageCacheOverflow = zero;
+            this->pageCacheSize = zero;
+            this->parserStack = zero;
+        }
+
+        connection_stats connection_stats::operator-(const connection_stats& earlier) const
+        {
+            connection_stats result;
+            result.lookasideUsed = Difference(this->lookasideUsed, earlier.lookasideUsed);
+            result.lookasideHit = Difference(this->lookasideHit, earlier.lookasideHit);
+            result.lookasideMissSize = Difference(this->lookasideMissSize, earlier.lookasideMissSize);
+            result.lookasideMissFull = Difference(this->lookasideMissFull, earlier.lookasideMissFull);
+            result.cacheUsed = Difference(this->cacheUsed, earlier.cacheUsed);
+            result.cacheUsedShared = Difference(this->cacheUsedShared, earlier.cacheUsedShared);
+            result.cacheHit = Difference(this->cacheHit, earlier.cacheHit);
+            result.cacheMiss = Difference(this->cacheMiss, earlier.cacheMiss);
+            result.cacheWrite = Difference(this->cacheWrite, earlier.cacheWrite);
+            result.cacheSpill = Difference(this->cacheSpill, earlier.cacheSpill);
+            result.schemaUsed = Difference(this->schemaUsed, earlier.schemaUsed);
+            result.statementUsed = Difference(this->statementUsed, earlier.statementUsed);
+            result.deferredForeignKeys = Difference(this->deferredForeignKeys, earlier.deferredForeignKeys);
+            result.memoryUsed = Difference(this->memoryUsed, earlier.memoryUsed);
+            result.mallocSize = Difference(this->mallocSize, earlier.mallocSize);
+            result.mallocCount = Difference(this->mallocCount, earlier.mallocCount);
+            result.pageCacheUsed = Difference(this->pageCacheUsed, earlier.pageCacheUsed);
+            result.pageCacheOverflow = Difference(this->pageCacheOverflow, earlier.pageCacheOverflow);
+            result.pageCacheSize = Difference(this->pageCacheSize, earlier.pageCacheSize);
+            result.parserStack = Difference(this->parserStack, earlier.parserStack);
+            return result;
+        }
+
+        connection_stats connection_stats::Read(sqlite3* dbObject, bool reset)
+        {
+            connection_stats result;
+            result.lookasideUsed = DbStatus(dbObject, SQLITE_DBSTATUS_LOOKASIDE_USED, reset);
+            result.lookasideHit = DbStatus(dbObject, SQLITE_DBSTATUS_LOOKASIDE_HIT, reset);
+            result.lookasideMissSize = DbStatus(dbObject, SQLITE_DBSTATUS_LOOKASIDE_MISS_SIZE, reset);
+            result.lookasideMissFull = DbStatus(dbObject, SQLITE_DBSTATUS_LOOKASIDE_MISS_FULL, reset);
+            result.cacheUsed = DbStatus(dbObject, SQLITE_DBSTATUS_CACHE_USED, reset);
+            result.cacheUsedShared = DbStatus(dbObject, SQLITE_DBSTATUS_CACHE_USED_SHARED, reset);
+            result.cacheHit = DbStatus(dbObject, SQLITE_DBSTATUS_CACHE_HIT, reset);
+            result.cacheMiss = DbStatus(dbObject, SQLITE_DBSTATUS_CACHE_MISS, reset);
+            result.cacheWrite = DbStatus(dbObject, SQLITE_DBSTATUS_CACHE_WRITE, reset);
+
+            #if SQLITE_VERSION_NUMBER >= 3023000
+                result.cacheSpill = DbStatus(dbObject, SQLITE_DBSTATUS_CACHE_SPILL, reset);
+            #endif // SQLITE_VERSION_NUMBER
+
+            result.schemaUsed = DbStatus(dbObject, SQLITE_DBSTATUS_SCHEMA_USED, reset);
+            result.statementUsed = DbStatus(dbObject, SQLITE_DBSTATUS_STMT_USED, reset);
+            result.deferredForeignKeys = DbStatus(dbObject, SQLITE_DBSTATUS_DEFERRED_FKS, reset);
+
+            result.memoryUsed = GlobalStatus(SQLITE_STATUS_MEMORY_USED);
+            result.mallocSize = GlobalStatus(SQLITE_STATUS_MALLOC_SIZE);
+            result.mallocCount = GlobalStatus(SQLITE_STATUS_MALLOC_COUNT);
+            result.pageCacheUsed = GlobalStatus(SQLITE_STATUS_PAGECACHE_USED);
+            result.pageCacheOverflow = GlobalStatus(SQLITE_STATUS_PAGECACHE_OVERFLOW);
+            result.pageCacheSize = GlobalStatus(SQLITE_STATUS_PAGECACHE_SIZE);
+            result.parserStack = GlobalStatus(SQLITE_STATUS_PARSER_STACK);
+            return result;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
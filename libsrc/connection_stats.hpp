@@ -0,0 +1,73 @@
+#if !defined CONNECTION_STATS_BB0AB32CCFEF460D816674433F5C255D
+#define CONNECTION_STATS_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstdint>
+#include <sqlite3.h>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Current and highest value of a SQLite status counter.
+         */
+        struct status_value
+        {
+            int64_t current;    ///< Current value.
+            int64_t highwater;  ///< Highest value since the counter was last reset.
+        }; // struct status_value
+
+        /**
+         * @brief Snapshot of the cache and memory statistics of a connection, read with \c sqlite3_db_status(), and
+         * of the memory statistics of the process, read with \c sqlite3_status64().
+         * @details Two snapshots can be subtracted to get the activity between two points in time, which is meaningful
+         * for the hit, miss and write counters. Counters that the SQLite version does not support are zero.
+         */
+        struct connection_stats
+        {
+            status_value lookasideUsed;         ///< Lookaside memory slots in use.
+            status_value lookasideHit;          ///< Allocations served from lookaside memory, in \c highwater.
+            status_value lookasideMissSize;     ///< Allocations too large for lookaside memory, in \c highwater.
+            status_value lookasideMissFull;     ///< Allocations that found lookaside memory full, in \c highwater.
+            status_value cacheUsed;             ///< Bytes of heap memory used by the page cache.
+            status_value cacheUsedShared;       ///< Bytes of page cache memory, with shared caches divided between their connections.
+            status_value cacheHit;              ///< Page cache hits.
+            status_value cacheMiss;             ///< Page cache misses.
+            status_value cacheWrite;            ///< Dirty pages written to the database file.
+            status_value cacheSpill;            ///< Dirty pages written in the middle of a transaction because the cache was full.
+            status_value schemaUsed;            ///< Bytes of heap memory used by the schemas.
+            status_value statementUsed;         ///< Bytes of heap memory used by the prepared statements.
+            status_value deferredForeignKeys;   ///< Non-zero if deferred foreign key constraints are unresolved.
+            status_value memoryUsed;            ///< Bytes of heap memory used by SQLite in the process.
+            status_value mallocSize;            ///< Largest allocation request of the process, in \c highwater.
+            status_value mallocCount;           ///< Number of separate allocations of the process.
+            status_value pageCacheUsed;         ///< Pages used from the process-wide page cache memory.
+            status_value pageCacheOverflow;     ///< Bytes of page cache allocations that did not fit into the page cache memory.
+            status_value pageCacheSize;         ///< Largest page cache allocation request, in \c highwater.
+            status_value parserStack;           ///< Deepest parser stack, in \c highwater.
+
+            /**
+             * @brief Construct a snapshot with all values set to zero.
+             */
+            connection_stats();
+
+            /**
+             * @brief Subtract the values of an earlier snapshot.
+             * @param earlier The earlier snapshot.
+             * @returns Returns the differences of all current and highest values.
+             */
+            connection_stats operator-(const connection_stats& earlier) const;
+
+            /**
+             * @brief Read the statistics of a connection and of the process.
+             * @param dbObject The connection.
+             * @param reset Flag that is set to reset the highest values and the hit, miss and write counters of the
+             * connection after they are read. The process-wide values are not reset.
+             * @returns Returns the snapshot.
+             */
+            static connection_stats Read(sqlite3* dbObject, bool reset);
+        }; // struct connection_stats
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // CONNECTION_STATS_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,407 @@
+#include "container_table.hpp"
+#include "sqlite_exception.hpp"
+#include <cmath>
+#include <exception>
+#include <new>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::string;
+
+        container_table_base::container_table_base(const std::vector<column_definition>& definitions, bool writable)
+            :   _definitions(definitions),
+                _keyColumns(),
+                _writable(writable),
+                _deleted(),
+                _deletedCount(0u)
+        {
+            for (size_t i = 0u; i < this->_definitions.size(); ++i)
+            {
+                if (this->_definitions[i].sortedKey)
+                {
+                    this->_keyColumns.push_back((int)i);
+                }
+            }
+        }
+
+        container_table_base::~container_table_base()
+        {
+        }
+
+        void container_table_base::Register(sqlite& dbObject, const string& name, container_table_base* table)
+        {
+            // SQLite calls DestroyTable() if the registration fails.
+            int rc = sqlite3_create_module_v2(dbObject._dbObject, name.c_str(), Module(table->_writable), table, &container_table_base::DestroyTable);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, sqlite3_errmsg(dbObject._dbObject));
+            }
+        }
+
+        void container_table_base::Delete(size_t index)
+        {
+            if (this->_deleted.size() <= index)
+            {
+                this->_deleted.resize(this->RowCount(), 0u);
+            }
+
+            if (this->_deleted[index] == 0u)
+            {
+                this->_deleted[index] = 1u;
+                ++this->_deletedCount;
+            }
+        }
+
+        bool container_table_base::IsNoChange(sqlite3_value* value)
+        {
+            #if SQLITE_VERSION_NUMBER >= 3022000
+            return sqlite3_value_nochange(value) != 0;
+            #else
+            (void)value;
+            return false;
+            #endif // SQLITE_VERSION_NUMBER
+        }
+
+        int container_table_base::Error(sqlite3_vtab* table, int rc, const char* message)
+        {
+            sqlite3_free(table->zErrMsg);
+            table->zErrMsg = sqlite3_mprintf("%s", message);
+            return rc;
+        }
+
+        string container_table_base::Declaration() const
+        {
+            string sql = "CREATE TABLE x(";
+            for (size_t i = 0u; i < this->_definitions.size(); ++i)
+            {
+                if (i > 0u)
+                {
+                    sql += ", ";
+                }
+
+                sql += '"';
+                for (char c : this->_definitions[i].name)
+                {
+                    sql += c;
+                    if (c == '"')
+                    {
+                        sql += '"';
+                    }
+                }
+
+                sql += "\" ";
+                sql += this->_definitions[i].type;
+            }
+
+            sql += ")";
+            return sql;
+        }
+
+        bool container_table_base::UsableConstraint(sqlite3_index_info* info, int constraint, int column) const
+        {
+            if (!this->_definitions[(size_t)column].textKey)
+            {
+                return true;
+            }
+
+            // Text keys are sorted by the BINARY collation, so other collations must be checked by SQLite.
+            #if SQLITE_VERSION_NUMBER >= 3022000
+            const char* collation = sqlite3_vtab_collation(info, constraint);
+            return (collation == nullptr) || (sqlite3_stricmp(collation, "BINARY") == 0);
+            #else
+            (void)info;
+            (void)constraint;
+            return false;
+            #endif // SQLITE_VERSION_NUMBER
+        }
+
+        void container_table_base::DestroyTable(void* table)
+        {
+            delete (container_table_base*)table;
+        }
+
+        int container_table_base::Connect(sqlite3* dbObject, void* userData, int /*argc*/, const char* const* /*argv*/, sqlite3_vtab** table, char** errorMessage)
+        {
+            container_table_base* tableObject = (container_table_base*)userData;
+            int rc = sqlite3_declare_vtab(dbObject, tableObject->Declaration().c_str());
+            if (rc != SQLITE_OK)
+            {
+                *errorMessage = sqlite3_mprintf("%s", sqlite3_errmsg(dbObject));
+                return rc;
+            }
+
+            vtab* tablePtr = new (std::nothrow) vtab();
+            if (tablePtr == nullptr)
+            {
+                return SQLITE_NOMEM;
+            }
+
+            tablePtr->table = tableObject;
+            *table = tablePtr;
+            return SQLITE_OK;
+        }
+
+        int container_table_base::Disconnect(sqlite3_vtab* table)
+        {
+            delete (vtab*)table;
+            return SQLITE_OK;
+        }
+
+        int container_table_base::BestIndex(sqlite3_vtab* table, sqlite3_index_info* info)
+        {
+            const container_table_base* tableObject = ((vtab*)table)->table;
+            double rowCount = (double)tableObject->RowCount();
+            double rows = rowCount;
+            int plan = 0;
+            int argument = 0;
+
+            // Equalities on leading key columns, followed by a range on the next key column, select a contiguous range
+            // of the sorted rows. The constraints are not omitted, because a value of another storage class cannot be
+            // used for the binary search and is left to SQLite.
+            for (size_t key = 0u; key < tableObject->_keyColumns.size(); ++key)
+            {
+                int column = tableObject->_keyColumns[key];
+                int equality = -1;
+                int lower = -1;
+                int upper = -1;
+                for (int i = 0; i < info->nConstraint; ++i)
+                {
+                    const sqlite3_index_info::sqlite3_index_constraint& constraint = info->aConstraint[i];
+                    if (!constraint.usable || (constraint.iColumn != column) || !tableObject->UsableConstraint(info, i, column))
+                    {
+                        continue;
+                    }
+
+                    switch (constraint.op)
+                    {
+                        case SQLITE_INDEX_CONSTRAINT_EQ:
+                            equality = (equality < 0) ? i : equality;
+                            break;
+                        case SQLITE_INDEX_CONSTRAINT_GT:
+                        case SQLITE_INDEX_CONSTRAINT_GE:
+                            lower = (lower < 0) ? i : lower;
+                            break;
+                        case SQLITE_INDEX_CONSTRAINT_LT:
+                        case SQLITE_INDEX_CONSTRAINT_LE:
+                            upper = (upper < 0) ? i : upper;
+                            break;
+                        default:
+                            break;
+                    }
+                }
+
+                if (equality >= 0)
+                {
+                    info->aConstraintUsage[equality].argvIndex = ++argument;
+                    ++plan;
+                    rows /= 10.0;
+                    continue;
+                }
+
+                if (lower >= 0)
+                {
+                    info->aConstraintUsage[lower].argvIndex = ++argument;
+                    plan |= plan_lower | ((info->aConstraint[lower].op == SQLITE_INDEX_CONSTRAINT_GT) ? plan_lower_exclusive : 0);
+                    rows /= 4.0;
+                }
+
+                if (upper >= 0)
+                {
+                    info->aConstraintUsage[upper].argvIndex = ++argument;
+                    plan |= plan_upper | ((info->aConstraint[upper].op == SQLITE_INDEX_CONSTRAINT_LT) ? plan_upper_exclusive : 0);
+                    rows /= 4.0;
+                }
+
+                break;
+            }
+
+            // The rows are returned in key order, so an ascending ORDER BY on a prefix of the key needs no sorting.
+            bool ordered = (info->nOrderBy > 0) && ((size_t)info->nOrderBy <= tableObject->_keyColumns.size());
+            for (int i = 0; ordered && (i < info->nOrderBy); ++i)
+            {
+                ordered = (info->aOrderBy[i].iColumn == tableObject->_keyColumns[(size_t)i]) && !info->aOrderBy[i].desc;
+            }
+
+            info->idxNum = plan;
+            info->orderByConsumed = ordered ? 1 : 0;
+            info->estimatedRows = (sqlite3_int64)((rows < 1.0) ? 1.0 : rows);
+            info->estimatedCost = (plan != 0) ? (std::log2(rowCount + 1.0) + rows) : rowCount;
+            return SQLITE_OK;
+        }
+
+        int container_table_base::Open(sqlite3_vtab* /*table*/, sqlite3_vtab_cursor** cursorOut)
+        {
+            cursor* cursorPtr = new (std::nothrow) cursor();
+            if (cursorPtr == nullptr)
+            {
+                return SQLITE_NOMEM;
+            }
+
+            *cursorOut = cursorPtr;
+            return SQLITE_OK;
+        }
+
+        int container_table_base::Close(sqlite3_vtab_cursor* cursorPtr)
+        {
+            delete (cursor*)cursorPtr;
+            return SQLITE_OK;
+        }
+
+        int container_table_base::Filter(sqlite3_vtab_cursor* cursorPtr, int plan, const char* /*planText*/, int /*argc*/, sqlite3_value** argv)
+        {
+            cursor* scan = (cursor*)cursorPtr;
+            const container_table_base* tableObject = ((vtab*)cursorPtr->pVtab)->table;
+            try
+            {
+                tableObject->FindRange(plan, argv, scan->index, scan->end);
+            }
+            catch (const std::exception& ex)
+            {
+                return Error(cursorPtr->pVtab, SQLITE_ERROR, ex.what());
+            }
+
+            while ((scan->index < scan->end) && tableObject->IsDeleted(scan->index))
+            {
+                ++scan->index;
+            }
+
+            return SQLITE_OK;
+        }
+
+        int container_table_base::Next(sqlite3_vtab_cursor* cursorPtr)
+        {
+            cursor* scan = (cursor*)cursorPtr;
+            const container_table_base* tableObject = ((vtab*)cursorPtr->pVtab)->table;
+            do
+            {
+                ++scan->index;
+            }
+            while ((scan->index < scan->end) && tableObject->IsDeleted(scan->index));
+
+            return SQLITE_OK;
+        }
+
+        int container_table_base::Eof(sqlite3_vtab_cursor* cursorPtr)
+        {
+            // The container may have been compacted by another statement of the connection.
+            cursor* scan = (cursor*)cursorPtr;
+            return ((scan->index >= scan->end) || (scan->index >= ((vtab*)cursorPtr->pVtab)->table->RowCount())) ? 1 : 0;
+        }
+
+        int container_table_base::ColumnValue(sqlite3_vtab_cursor* cursorPtr, sqlite3_context* context, int column)
+        {
+            #if SQLITE_VERSION_NUMBER >= 3022000
+            // The value of a column that an UPDATE does not change is not needed, see IsNoChange().
+            if (sqlite3_vtab_nochange(context))
+            {
+                return SQLITE_OK;
+            }
+            #endif // SQLITE_VERSION_NUMBER
+
+            try
+            {
+                ((vtab*)cursorPtr->pVtab)->table->Column(context, ((cursor*)cursorPtr)->index, column);
+            }
+            catch (...)
+            {
+                ReportFunctionError(context);
+            }
+
+            return SQLITE_OK;
+        }
+
+        int container_table_base::RowId(sqlite3_vtab_cursor* cursorPtr, sqlite3_int64* rowId)
+        {
+            *rowId = (sqlite3_int64)((cursor*)cursorPtr)->index;
+            return SQLITE_OK;
+        }
+
+        int container_table_base::Update(sqlite3_vtab* table, int argc, sqlite3_value** argv, sqlite3_int64* rowId)
+        {
+            container_table_base* tableObject = ((vtab*)table)->table;
+            try
+            {
+                if (argc == 1)
+                {
+                    sqlite3_int64 index = sqlite3_value_int64(argv[0]);
+                    if ((index >= 0) && ((size_t)index < tableObject->RowCount()))
+                    {
+                        tableObject->Delete((size_t)index);
+                    }
+
+                    return SQLITE_OK;
+                }
+
+                return tableObject->Store(table, argc, argv, rowId);
+            }
+            catch (const std::bad_alloc&)
+            {
+                return SQLITE_NOMEM;
+            }
+            catch (const std::exception& ex)
+            {
+                return Error(table, SQLITE_ERROR, ex.what());
+            }
+        }
+
+        int container_table_base::Begin(sqlite3_vtab* /*table*/)
+        {
+            return SQLITE_OK;
+        }
+
+        int container_table_base::Commit(sqlite3_vtab* table)
+        {
+            // Also used for rollbacks, because the other changes cannot be undone either.
+            try
+            {
+                ((vtab*)table)->table->Compact();
+            }
+            catch (const std::exception& ex)
+            {
+                return Error(table, SQLITE_ERROR, ex.what());
+            }
+
+            return SQLITE_OK;
+        }
+
+        const sqlite3_module* container_table_base::Module(bool writable)
+        {
+            struct modules
+            {
+                sqlite3_module readOnly;    ///< Module of read-only tables.
+                sqlite3_module writable;    ///< Module of writable tables.
+
+                modules()
+                    :   readOnly(),
+                        writable()
+                {
+                    // xCreate is not set, so the tables are eponymous and need no CREATE VIRTUAL TABLE.
+                    this->readOnly.iVersion = 1;
+                    this->readOnly.xConnect = &container_table_base::Connect;
+                    this->readOnly.xBestIndex = &container_table_base::BestIndex;
+                    this->readOnly.xDisconnect = &container_table_base::Disconnect;
+                    this->readOnly.xDestroy = &container_table_base::Disconnect;
+                    this->readOnly.xOpen = &container_table_base::Open;
+                    this->readOnly.xClose = &container_table_base::Close;
+                    this->readOnly.xFilter = &container_table_base::Filter;
+                    this->readOnly.xNext = &container_table_base::Next;
+                    this->readOnly.xEof = &container_table_base::Eof;
+                    this->readOnly.xColumn = &container_table_base::ColumnValue;
+                    this->readOnly.xRowid = &container_table_base::RowId;
+
+                    this->writable = this->readOnly;
+                    this->writable.xUpdate = &container_table_base::Update;
+                    this->writable.xBegin = &container_table_base::Begin;
+                    this->writable.xSync = &container_table_base::Begin;
+                    this->writable.xCommit = &container_table_base::Commit;
+                    this->writable.xRollback = &container_table_base::Commit;
+                }
+            };
+
+            static const modules instance;
+            return writable ? &instance.writable : &instance.readOnly;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
@@ -0,0 +1,1033 @@
+#if !defined CONTAINER_TABLE_BB0AB32CCFEF460D816674433F5C255D
+#define CONTAINER_TABLE_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "sql_function.hpp"
+#include "sqlite.hpp"
+#include "sqlite_exception.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Type in which a column of C++ type \p T is exchanged with SQLite. Integral types other than \c int and
+         * \c bool are exchanged as \c int64_t and floating point types as \c double.
+         */
+        template <typename T, typename Enable = void> struct column_storage
+        {
+            using type = T;
+        };
+
+        template <typename T> struct column_storage<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, int>::value && !std::is_same<T, bool>::value>::type>
+        {
+            using type = int64_t;
+        };
+
+        template <typename T> struct column_storage<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+        {
+            using type = double;
+        };
+
+        /**
+         * @brief Declared SQL type of a column of C++ type \p T.
+         */
+        template <typename T, typename Enable = void> struct column_sql_type
+        {
+            static inline const char* Name() { return ""; }
+        };
+
+        template <typename T> struct column_sql_type<T, typename std::enable_if<std::is_integral<T>::value>::type>
+        {
+            static inline const char* Name() { return "INTEGER"; }
+        };
+
+        template <typename T> struct column_sql_type<T, typename std::enable_if<std::is_floating_point<T>::value>::type>
+        {
+            static inline const char* Name() { return "REAL"; }
+        };
+
+        template <> struct column_sql_type<std::string>
+        {
+            static inline const char* Name() { return "TEXT"; }
+        };
+
+        template <> struct column_sql_type<text_view>
+        {
+            static inline const char* Name() { return "TEXT"; }
+        };
+
+        template <> struct column_sql_type< std::vector<uint8_t> >
+        {
+            static inline const char* Name() { return "BLOB"; }
+        };
+
+        template <> struct column_sql_type<blob_span>
+        {
+            static inline const char* Name() { return "BLOB"; }
+        };
+
+        /**
+         * @brief Sets the value of a column of C++ type \p T as the result of \c xColumn. Text and BLOB members are
+         * returned without a copy if \p copy is not set.
+         */
+        template <typename T> struct column_result
+        {
+            static inline void Write(sqlite3_context* context, const T& value, bool /*copy*/) { function_result<typename column_storage<T>::type>::Write(context, (typename column_storage<T>::type)value); }
+        };
+
+        template <> struct column_result<std::string>
+        {
+            static inline void Write(sqlite3_context* context, const std::string& value, bool copy) { sqlite3_result_text64(context, value.data(), (sqlite3_uint64)value.size(), copy ? SQLITE_TRANSIENT : SQLITE_STATIC, SQLITE_UTF8); }
+        };
+
+        template <> struct column_result< std::vector<uint8_t> >
+        {
+            static inline void Write(sqlite3_context* context, const std::vector<uint8_t>& value, bool copy)
+            {
+                // An empty vector may have no buffer, which SQLite would return as NULL.
+                if (value.empty())
+                {
+                    sqlite3_result_zeroblob(context, 0);
+                    return;
+                }
+
+                sqlite3_result_blob64(context, value.data(), (sqlite3_uint64)value.size(), copy ? SQLITE_TRANSIENT : SQLITE_STATIC);
+            }
+        };
+
+        /**
+         * @brief Stores an SQL value in a column of C++ type \p T. Views cannot be stored, because they would outlive
+         * the value.
+         */
+        template <typename T> struct column_assign
+        {
+            static inline bool Assign(T& target, sqlite3_value* value)
+            {
+                target = (T)function_argument<typename column_storage<T>::type>::Read(value);
+                return true;
+            }
+        };
+
+        template <> struct column_assign<text_view>
+        {
+            static inline bool Assign(text_view& /*target*/, sqlite3_value* /*value*/) { return false; }
+        };
+
+        template <> struct column_assign<blob_span>
+        {
+            static inline bool Assign(blob_span& /*target*/, sqlite3_value* /*value*/) { return false; }
+        };
+
+        /**
+         * @brief Comparison of a sorted key column of C++ type \p T, in the order that SQLite uses for the values of
+         * the column. Keys are supported for arithmetic, text and BLOB types. Text is compared with the \c BINARY
+         * collation. Unsigned 64-bit integers are not supported, because values from 2^63 on are exchanged as negative
+         * \c int64_t values, so a container in unsigned order is not in the order of the column.
+         */
+        template <typename T, typename Enable = void> struct column_key
+        {
+            static const bool Supported = false;    ///< Flag that is set if \p T can be a sorted key.
+            static const bool Text = false;         ///< Flag that is set if \p T is compared with a collation.
+
+            static inline bool Comparable(sqlite3_value* /*value*/) { return false; }
+            static inline int Compare(const T& /*key*/, sqlite3_value* /*value*/) { return 0; }
+            static inline int Compare(const T& /*left*/, const T& /*right*/) { return 0; }
+        };
+
+        template <typename T> struct column_key<T, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+        {
+            static const bool Supported = !(std::is_unsigned<T>::value && (sizeof(T) >= sizeof(int64_t)));
+            static const bool Text = false;
+
+            static inline bool Comparable(sqlite3_value* value)
+            {
+                int type = sqlite3_value_type(value);
+                return (type == SQLITE_INTEGER) || (type == SQLITE_FLOAT);
+            }
+
+            static inline int Compare(const T& key, sqlite3_value* value)
+            {
+                if (std::is_integral<T>::value && (sqlite3_value_type(value) == SQLITE_INTEGER))
+                {
+                    int64_t left = (int64_t)key;
+                    int64_t right = (int64_t)sqlite3_value_int64(value);
+                    return (left < right) ? -1 : ((right < left) ? 1 : 0);
+                }
+
+                double left = (double)key;
+                double right = sqlite3_value_double(value);
+                return (left < right) ? -1 : ((right < left) ? 1 : 0);
+            }
+
+            static inline int Compare(const T& left, const T& right)
+            {
+                return (left < right) ? -1 : ((right < left) ? 1 : 0);
+            }
+        };
+
+        /**
+         * @brief Comparison of text and BLOB values, in the order of the \c BINARY collation and of BLOB values.
+         */
+        struct column_bytes_key
+        {
+            static inline int CompareBytes(const void* left, size_t leftSize, const void* right, size_t rightSize)
+            {
+                size_t common = (leftSize < rightSize) ? leftSize : rightSize;
+                int result = (common == 0u) ? 0 : std::memcmp(left, right, common);
+                if (result != 0)
+                {
+                    return (result < 0) ? -1 : 1;
+                }
+
+                return (leftSize < rightSize) ? -1 : ((rightSize < leftSize) ? 1 : 0);
+            }
+        };
+
+        template <> struct column_key<std::string> : public column_bytes_key
+        {
+            static const bool Supported = true;
+            static const bool Text = true;
+
+            static inline bool Comparable(sqlite3_value* value) { return sqlite3_value_type(value) == SQLITE_TEXT; }
+
+            static inline int Compare(const std::string& key, sqlite3_value* value)
+            {
+                text_view text = function_argument<text_view>::Read(value);
+                return CompareBytes(key.data(), key.size(), text.data(), text.size());
+            }
+
+            static inline int Compare(const std::string& left, const std::string& right) { return CompareBytes(left.data(), left.size(), right.data(), right.size()); }
+        };
+
+        template <> struct column_key<text_view> : public column_bytes_key
+        {
+            static const bool Supported = true;
+            static const bool Text = true;
+
+            static inline bool Comparable(sqlite3_value* value) { return sqlite3_value_type(value) == SQLITE_TEXT; }
+
+            static inline int Compare(const text_view& key, sqlite3_value* value)
+            {
+                text_view text = function_argument<text_view>::Read(value);
+                return CompareBytes(key.data(), key.size(), text.data(), text.size());
+            }
+
+            static inline int Compare(const text_view& left, const text_view& right) { return CompareBytes(left.data(), left.size(), right.data(), right.size()); }
+        };
+
+        template <> struct column_key< std::vector<uint8_t> > : public column_bytes_key
+        {
+            static const bool Supported = true;
+            static const bool Text = false;
+
+            static inline bool Comparable(sqlite3_value* value) { return sqlite3_value_type(value) == SQLITE_BLOB; }
+
+            static inline int Compare(const std::vector<uint8_t>& key, sqlite3_value* value)
+            {
+                blob_span blob = function_argument<blob_span>::Read(value);
+                return CompareBytes(key.data(), key.size(), blob.data(), blob.size());
+            }
+
+            static inline int Compare(const std::vector<uint8_t>& left, const std::vector<uint8_t>& right) { return CompareBytes(left.data(), left.size(), right.data(), right.size()); }
+        };
+
+        template <> struct column_key<blob_span> : public column_bytes_key
+        {
+            static const bool Supported = true;
+            static const bool Text = false;
+
+            static inline bool Comparable(sqlite3_value* value) { return sqlite3_value_type(value) == SQLITE_BLOB; }
+
+            static inline int Compare(const blob_span& key, sqlite3_value* value)
+            {
+                blob_span blob = function_argument<blob_span>::Read(value);
+                return CompareBytes(key.data(), key.size(), blob.data(), blob.size());
+            }
+
+            static inline int Compare(const blob_span& left, const blob_span& right) { return CompareBytes(left.data(), left.size(), right.data(), right.size()); }
+        };
+
+        /**
+         * @brief Detects a container with \c push_back() and \c erase(), which a writable container table needs.
+         */
+        template <typename Container, typename Enable = void> struct has_push_back_erase : public std::false_type
+        {
+        };
+
+        template <typename Container> struct has_push_back_erase<Container, typename std::conditional<true, void, decltype(
+            std::declval<Container&>().push_back(std::declval<typename Container::value_type>()),
+            std::declval<Container&>().erase(std::declval<Container&>().begin(), std::declval<Container&>().end()))>::type> : public std::true_type
+        {
+        };
+
+        /**
+         * @brief Name and properties of a column of a container table.
+         */
+        struct column_definition
+        {
+            std::string name;   ///< Name of the column.
+            std::string type;   ///< Declared SQL type of the column.
+            bool sortedKey;     ///< Flag that is set if the rows are sorted by the column, see table_columns::Add().
+            bool textKey;       ///< Flag that is set if the key is compared with a collation.
+        }; // struct column_definition
+
+        /**
+         * @brief Access to one column of the rows of a container table.
+         */
+        template <typename Row> class table_column
+        {
+            public:
+                virtual ~table_column() {}
+
+            public:
+                /**
+                 * @brief Set the value of the column of a row as the result of \c xColumn.
+                 * @param context Context of the \c xColumn call.
+                 * @param row The row.
+                 * @param copy Flag that is set if SQLite must copy text and BLOB values.
+                 */
+                virtual void Read(sqlite3_context* context, const Row& row, bool copy) const = 0;
+
+                /**
+                 * @brief Store a value in the column of a row.
+                 * @param row The row.
+                 * @param value The value.
+                 * @retval true The value was stored.
+                 * @retval false The column cannot be written, for example because it is computed.
+                 */
+                virtual bool Write(Row& row, sqlite3_value* value) const = 0;
+
+                /**
+                 * @brief Check whether a constraint value can be compared with the column by Compare().
+                 * @param value The constraint value.
+                 * @retval true The value has the storage class of the column.
+                 * @retval false SQLite must compare the value.
+                 */
+                virtual bool Comparable(sqlite3_value* value) const = 0;
+
+                /**
+                 * @brief Compare the column of a row with a constraint value.
+                 * @param row The row.
+                 * @param value The constraint value, for which Comparable() returned \c true.
+                 * @returns Returns a negative value, zero or a positive value if the column is less than, equal to or
+                 * greater than the value.
+                 */
+                virtual int Compare(const Row& row, sqlite3_value* value) const = 0;
+
+                /**
+                 * @brief Compare the column of two rows.
+                 * @param left The first row.
+                 * @param right The second row.
+                 * @returns Returns a negative value, zero or a positive value if the column of \p left is less than,
+                 * equal to or greater than the column of \p right.
+                 */
+                virtual int CompareRows(const Row& left, const Row& right) const = 0;
+        }; // class table_column
+
+        /**
+         * @brief Column that is a data member of the row.
+         */
+        template <typename Row, typename Member> class member_column : public table_column<Row>
+        {
+            private:
+                Member Row::* _member; ///< The data member.
+
+            public:
+                explicit member_column(Member Row::* member) : _member(member) {}
+
+            public:
+                virtual void Read(sqlite3_context* context, const Row& row, bool copy) const { column_result<Member>::Write(context, row.*this->_member, copy); }
+                virtual bool Write(Row& row, sqlite3_value* value) const { return column_assign<Member>::Assign(row.*this->_member, value); }
+                virtual bool Comparable(sqlite3_value* value) const { return column_key<Member>::Comparable(value); }
+                virtual int Compare(const Row& row, sqlite3_value* value) const { return column_key<Member>::Compare(row.*this->_member, value); }
+                virtual int CompareRows(const Row& left, const Row& right) const { return column_key<Member>::Compare(left.*this->_member, right.*this->_member); }
+        }; // class member_column
+
+        /**
+         * @brief Read-only column whose value is computed from the row.
+         */
+        template <typename Row, typename Getter> class computed_column : public table_column<Row>
+        {
+            public:
+                using value_type = typename function_traits<Getter>::result_type; ///< Type of the computed value.
+
+            private:
+                Getter _getter; ///< Computes the value from a row.
+
+            public:
+                explicit computed_column(Getter getter) : _getter(std::move(getter)) {}
+
+            public:
+                virtual void Read(sqlite3_context* context, const Row& row, bool /*copy*/) const { column_result<value_type>::Write(context, this->_getter(row), true); }
+                virtual bool Write(Row& /*row*/, sqlite3_value* /*value*/) const { return false; }
+                virtual bool Comparable(sqlite3_value* value) const { return column_key<value_type>::Comparable(value); }
+                virtual int Compare(const Row& row, sqlite3_value* value) const { return column_key<value_type>::Compare(this->_getter(row), value); }
+                virtual int CompareRows(const Row& left, const Row& right) const { return column_key<value_type>::Compare(this->_getter(left), this->_getter(right)); }
+        }; // class computed_column
+
+        /**
+         * @brief Column descriptors that map the rows of type \p Row of a container to the columns of an SQL table.
+         */
+        template <typename Row> class table_columns
+        {
+            private:
+                std::vector<column_definition> _definitions;                            ///< Names and properties of the columns.
+                std::vector< std::shared_ptr<const table_column<Row> > > _columns;      ///< Access to the columns.
+
+            public:
+                /**
+                 * @brief Add a column that is a data member of the row.
+                 * @param name Name of the column.
+                 * @param member The data member.
+                 * @param sortedKey Flag that is set if the rows are sorted by the column. The sorted key columns form a
+                 * composite key in the order in which they are added, and the container must be sorted by that key in
+                 * ascending order. Equality and range constraints on the key are then answered by binary search.
+                 * Unsigned 64-bit members such as \c uint64_t cannot be sorted keys. Text keys need SQLite 3.22 or
+                 * later, which reports the collation of a constraint, and are rejected when built against older headers.
+                 * @returns Returns a reference to this object.
+                 */
+                template <typename Member> table_columns& Add(const std::string& name, Member Row::* member, bool sortedKey = false);
+
+                /**
+                 * @brief Add a read-only column whose value is computed from the row.
+                 * @param name Name of the column.
+                 * @param getter Callable object that takes a <tt>const Row&</tt> and returns the value.
+                 * @param sortedKey Flag that is set if the rows are sorted by the column, see Add().
+                 * @returns Returns a reference to this object.
+                 */
+                template <typename Getter> table_columns& AddComputed(const std::string& name, Getter getter, bool sortedKey = false);
+
+                /**
+                 * @brief Returns the names and properties of the columns.
+                 */
+                inline const std::vector<column_definition>& Definitions() const;
+
+                /**
+                 * @brief Returns the access to a column.
+                 * @param index Index of the column.
+                 */
+                inline const table_column<Row>& Column(size_t index) const;
+
+            private:
+                /**
+                 * @brief Add a column.
+                 * @param name Name of the column.
+                 * @param type Declared SQL type of the column.
+                 * @param sortedKey Flag that is set if the rows are sorted by the column.
+                 * @param supportedKey Flag that is set if the type of the column can be a sorted key.
+                 * @param textKey Flag that is set if the key is compared with a collation.
+                 * @param column Access to the column.
+                 */
+                void AddColumn(const std::string& name, const char* type, bool sortedKey, bool supportedKey, bool textKey, std::shared_ptr<const table_column<Row> > column);
+        }; // class table_columns
+
+        /**
+         * @brief Part of a container table that does not depend on the type of the container. It implements the
+         * \c sqlite3_module callbacks and the query planning.
+         */
+        class container_table_base
+        {
+            protected:
+                /**
+                 * @brief Bits of the \c idxNum value that describes a scan. The low 8 bits hold the number of leading
+                 * key columns that are constrained by equality.
+                 */
+                enum scan_plan
+                {
+                    plan_equality_mask = 0xFF,      ///< Number of equality constraints.
+                    plan_lower = 0x100,             ///< The next key column has a lower bound.
+                    plan_lower_exclusive = 0x200,   ///< The lower bound is excluded.
+                    plan_upper = 0x400,             ///< The next key column has an upper bound.
+                    plan_upper_exclusive = 0x800    ///< The upper bound is excluded.
+                };
+
+                /**
+                 * @brief Virtual table object, which SQLite requires to start with \c sqlite3_vtab.
+                 */
+                struct vtab : public sqlite3_vtab
+                {
+                    container_table_base* table; ///< The table.
+                };
+
+                /**
+                 * @brief Cursor object, which SQLite requires to start with \c sqlite3_vtab_cursor.
+                 */
+                struct cursor : public sqlite3_vtab_cursor
+                {
+                    size_t index;   ///< Index of the current row.
+                    size_t end;     ///< Index behind the last row of the scan.
+                };
+
+            protected:
+                std::vector<column_definition> _definitions;    ///< Names and properties of the columns.
+                std::vector<int> _keyColumns;                   ///< Indexes of the sorted key columns, in key order.
+                bool _writable;                                 ///< Flag that is set if the table accepts changes.
+                std::vector<uint8_t> _deleted;                  ///< Flags of the rows deleted in the current transaction.
+                size_t _deletedCount;                           ///< Number of set flags in \c _deleted.
+
+            public:
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                container_table_base(const container_table_base& src) = delete;
+
+                /**
+                 * @brief Destructor.
+                 */
+                virtual ~container_table_base();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                container_table_base& operator=(const container_table_base& src) = delete;
+
+            protected:
+                /**
+                 * @brief Constructor.
+                 * @param definitions Names and properties of the columns.
+                 * @param writable Flag that is set if the table accepts changes.
+                 */
+                container_table_base(const std::vector<column_definition>& definitions, bool writable);
+
+                /**
+                 * @brief Register a table as an eponymous virtual table. The table is owned by the connection from now
+                 * on, also if the registration fails.
+                 * @param dbObject Reference to a \c sqlite object.
+                 * @param name Name of the table.
+                 * @param table The table.
+                 */
+                static void Register(sqlite& dbObject, const std::string& name, container_table_base* table);
+
+                /**
+                 * @brief Check whether a row has been deleted in the current transaction.
+                 * @param index Index of the row.
+                 */
+                inline bool IsDeleted(size_t index) const;
+
+                /**
+                 * @brief Flag a row as deleted. The row is removed from the container when the transaction ends.
+                 * @param index Index of the row.
+                 */
+                void Delete(size_t index);
+
+                /**
+                 * @brief Returns the number of rows in the container, including deleted rows.
+                 */
+                virtual size_t RowCount() const = 0;
+
+                /**
+                 * @brief Set the value of a column of a row as the result of \c xColumn.
+                 * @param context Context of the \c xColumn call.
+                 * @param index Index of the row.
+                 * @param column Index of the column.
+                 */
+                virtual void Column(sqlite3_context* context, size_t index, int column) const = 0;
+
+                /**
+                 * @brief Find the rows that satisfy the key constraints of a scan.
+                 * @param plan The \c scan_plan bits chosen by BestIndex().
+                 * @param values Values of the constraints, equalities first, then the lower and the upper bound.
+                 * @param begin Receives the index of the first row.
+                 * @param end Receives the index behind the last row.
+                 */
+                virtual void FindRange(int plan, sqlite3_value** values, size_t& begin, size_t& end) const = 0;
+
+                /**
+                 * @brief Insert or update a row, see \c xUpdate.
+                 * @param table The virtual table object, which receives the error message.
+                 * @param argc Number of values.
+                 * @param argv Old row id, new row id and the column values.
+                 * @param rowId Receives the row id of an inserted row.
+                 * @returns Returns \c SQLITE_OK or an error code.
+                 */
+                virtual int Store(sqlite3_vtab* table, int argc, sqlite3_value** argv, sqlite3_int64* rowId) = 0;
+
+                /**
+                 * @brief Remove the deleted rows from the container.
+                 */
+                virtual void Compact() = 0;
+
+                /**
+                 * @brief Check whether an \c UPDATE leaves a column unchanged, see \c sqlite3_value_nochange().
+                 * @param value Value of the column passed to \c xUpdate.
+                 * @retval true The column is not changed and its value is not available.
+                 * @retval false The value is available.
+                 */
+                static bool IsNoChange(sqlite3_value* value);
+
+                /**
+                 * @brief Set the error message of a virtual table.
+                 * @param table The virtual table object.
+                 * @param rc The error code.
+                 * @param message The error message.
+                 * @returns Returns \p rc.
+                 */
+                static int Error(sqlite3_vtab* table, int rc, const char* message);
+
+            private:
+                /**
+                 * @brief Returns the \c CREATE \c TABLE statement that declares the columns.
+                 */
+                std::string Declaration() const;
+
+                /**
+                 * @brief Check whether a constraint on a key column can be answered by binary search.
+                 * @param info The planning information.
+                 * @param constraint Index of the constraint.
+                 * @param column Index of the column.
+                 */
+                bool UsableConstraint(sqlite3_index_info* info, int constraint, int column) const;
+
+                static void DestroyTable(void* table);
+                static int Connect(sqlite3* dbObject, void* userData, int argc, const char* const* argv, sqlite3_vtab** table, char** errorMessage);
+                static int Disconnect(sqlite3_vtab* table);
+                static int BestIndex(sqlite3_vtab* table, sqlite3_index_info* info);
+                static int Open(sqlite3_vtab* table, sqlite3_vtab_cursor** cursorOut);
+                static int Close(sqlite3_vtab_cursor* cursorPtr);
+                static int Filter(sqlite3_vtab_cursor* cursorPtr, int plan, const char* planText, int argc, sqlite3_value** argv);
+                static int Next(sqlite3_vtab_cursor* cursorPtr);
+                static int Eof(sqlite3_vtab_cursor* cursorPtr);
+                static int ColumnValue(sqlite3_vtab_cursor* cursorPtr, sqlite3_context* context, int column);
+                static int RowId(sqlite3_vtab_cursor* cursorPtr, sqlite3_int64* rowId);
+                static int Update(sqlite3_vtab* table, int argc, sqlite3_value** argv, sqlite3_int64* rowId);
+                static int Begin(sqlite3_vtab* table);
+                static int Commit(sqlite3_vtab* table);
+
+                /**
+                 * @brief Returns the module of read-only or of writable tables.
+                 * @param writable Flag that is set for writable tables.
+                 */
+                static const sqlite3_module* Module(bool writable);
+        }; // class container_table_base
+
+        /**
+         * @brief Eponymous virtual table over the rows of a C++ container, see CreateContainerTable().
+         */
+        template <typename Container> class container_table : public container_table_base
+        {
+            public:
+                using row_type = typename std::remove_const<typename Container::value_type>::type; ///< Type of a row.
+
+            private:
+                Container* _rows;                   ///< The rows.
+                table_columns<row_type> _columns;   ///< Access to the columns.
+
+            public:
+                /**
+                 * @brief Constructor.
+                 * @param rows The rows.
+                 * @param columns Access to the columns.
+                 * @param writable Flag that is set if the table accepts changes.
+                 */
+                container_table(Container& rows, const table_columns<row_type>& columns, bool writable);
+
+                /**
+                 * @brief Register a table over a container with a connection.
+                 * @param dbObject Reference to a \c sqlite object.
+                 * @param name Name of the table.
+                 * @param rows The rows.
+                 * @param columns Access to the columns.
+                 * @param writable Flag that is set if the table accepts changes.
+                 */
+                static void Create(sqlite& dbObject, const std::string& name, Container& rows, const table_columns<row_type>& columns, bool writable);
+
+            protected:
+                virtual size_t RowCount() const;
+                virtual void Column(sqlite3_context* context, size_t index, int column) const;
+                virtual void FindRange(int plan, sqlite3_value** values, size_t& begin, size_t& end) const;
+                virtual int Store(sqlite3_vtab* table, int argc, sqlite3_value** argv, sqlite3_int64* rowId);
+                virtual void Compact();
+
+            private:
+                /**
+                 * @brief Binary search for the first row that is not before a bound of the key.
+                 * @param equalities Number of leading key columns constrained by equality.
+                 * @param values Values of the equalities.
+                 * @param bound Bound of the next key column, or \c nullptr.
+                 * @param upper Flag that is set if \p bound is an upper bound.
+                 * @param inclusive Flag that is set if rows equal to \p bound are part of the range.
+                 * @returns For a lower bound, returns the index of the first row of the range. For an upper bound,
+                 * returns the index behind the last row of the range.
+                 */
+                size_t Search(int equalities, sqlite3_value** values, sqlite3_value* bound, bool upper, bool inclusive) const;
+
+                /**
+                 * @brief Compare the key of two rows.
+                 * @returns Returns a negative value, zero or a positive value if the key of \p left is less than, equal
+                 * to or greater than the key of \p right.
+                 */
+                int CompareKeys(const row_type& left, const row_type& right) const;
+
+                /**
+                 * @brief Store the values of an \c INSERT or \c UPDATE in a row.
+                 * @param table The virtual table object, which receives the error message.
+                 * @param row The row that receives the values.
+                 * @param current The row before an update, or \c nullptr for an insert.
+                 * @param values One value per column.
+                 * @returns Returns \c SQLITE_OK, or \c SQLITE_CONSTRAINT if a column that cannot be written would
+                 * change.
+                 */
+                int WriteColumns(sqlite3_vtab* table, row_type& row, const row_type* current, sqlite3_value** values);
+
+                int Store(sqlite3_vtab* table, int argc, sqlite3_value** argv, sqlite3_int64* rowId, std::false_type);
+                int Store(sqlite3_vtab* table, int argc, sqlite3_value** argv, sqlite3_int64* rowId, std::true_type);
+                void Compact(std::false_type);
+                void Compact(std::true_type);
+        }; // class container_table
+
+        /**
+         * @brief Expose the rows of a C++ container as an SQL table of a connection, without copying them into a
+         * table of the database.
+         * @details The table is eponymous, so it can be used right away as \p name in the \c main schema and needs no
+         * <tt>CREATE VIRTUAL TABLE</tt>. Rows are read in place; for a read-only table, text and BLOB members are
+         * also passed to SQLite without a copy. Constraints on the sorted key columns are answered by binary search
+         * and an \c ORDER \c BY on a prefix of the key is satisfied without sorting. Text keys need SQLite 3.22 or
+         * later, see table_columns::Add(). Other constraints are checked by SQLite. The container must support random access and must stay valid and unchanged while a statement uses
+         * the table. The row id of a row is its index in the container.
+         *
+         * A writable table accepts \c INSERT, \c UPDATE and \c DELETE if the container has \c push_back() and
+         * \c erase(). Inserted rows are appended and must not break the order of the sorted key, and key columns
+         * cannot be updated. Computed and view columns cannot be written; a value that differs from the column's own
+         * value is rejected with \c SQLITE_CONSTRAINT. Deleted rows are removed from the container when the transaction
+         * ends. Changes are applied to the container right away and are not undone by \c ROLLBACK. A read-only table
+         * only needs random access, so it also works over a \c std::array or a const container.
+         * @param dbObject Reference to a \c sqlite object.
+         * @param name Name of the table.
+         * @param rows The rows, which must outlive the connection.
+         * @param columns Access to the columns.
+         * @param writable Flag that is set if the table accepts changes. It cannot be set for a const container.
+         */
+        template <typename Container> void CreateContainerTable(sqlite& dbObject, const std::string& name, Container& rows, const table_columns<typename std::remove_const<typename Container::value_type>::type>& columns, bool writable = false);
+
+        template <typename Row> template <typename Member> table_columns<Row>& table_columns<Row>::Add(const std::string& name, Member Row::* member, bool sortedKey)
+        {
+            this->AddColumn(name, column_sql_type<Member>::Name(), sortedKey, column_key<Member>::Supported, column_key<Member>::Text, std::make_shared< member_column<Row, Member> >(member));
+            return *this;
+        }
+
+        template <typename Row> template <typename Getter> table_columns<Row>& table_columns<Row>::AddComputed(const std::string& name, Getter getter, bool sortedKey)
+        {
+            using value_type = typename computed_column<Row, Getter>::value_type;
+            this->AddColumn(name, column_sql_type<value_type>::Name(), sortedKey, column_key<value_type>::Supported, column_key<value_type>::Text, std::make_shared< computed_column<Row, Getter> >(std::move(getter)));
+            return *this;
+        }
+
+        template <typename Row> inline const std::vector<column_definition>& table_columns<Row>::Definitions() const
+        {
+            return this->_definitions;
+        }
+
+        template <typename Row> inline const table_column<Row>& table_columns<Row>::Column(size_t index) const
+        {
+            return *this->_columns[index];
+        }
+
+        template <typename Row> void table_columns<Row>::AddColumn(const std::string& name, const char* type, bool sortedKey, bool supportedKey, bool textKey, std::shared_ptr<const table_column<Row> > column)
+        {
+            if (sortedKey && !supportedKey)
+            {
+                throw sqlite_exception(SQLITE_MISUSE, "The type of the column cannot be a sorted key");
+            }
+
+            #if SQLITE_VERSION_NUMBER < 3022000
+            // Without sqlite3_vtab_collation() no text constraint could use the key, so it would be silently ignored.
+            if (sortedKey && textKey)
+            {
+                throw sqlite_exception(SQLITE_MISUSE, "Text sorted keys need SQLite 3.22 or later");
+            }
+            #endif // SQLITE_VERSION_NUMBER
+
+            column_definition definition;
+            definition.name = name;
+            definition.type = type;
+            definition.sortedKey = sortedKey;
+            definition.textKey = textKey;
+            this->_definitions.push_back(std::move(definition));
+            this->_columns.push_back(std::move(column));
+        }
+
+        inline bool container_table_base::IsDeleted(size_t index) const
+        {
+            return (index < this->_deleted.size()) && (this->_deleted[index] != 0u);
+        }
+
+        template <typename Container> container_table<Container>::container_table(Container& rows, const table_columns<row_type>& columns, bool writable)
+            :   container_table_base(columns.Definitions(), writable),
+                _rows(&rows),
+                _columns(columns)
+        {
+        }
+
+        template <typename Container> void container_table<Container>::Create(sqlite& dbObject, const std::string& name, Container& rows, const table_columns<row_type>& columns, bool writable)
+        {
+            if (writable && !has_push_back_erase<Container>::value)
+            {
+                throw sqlite_exception(SQLITE_MISUSE, "A writable container table needs a non-const container with push_back() and erase()");
+            }
+
+            Register(dbObject, name, new container_table<Container>(rows, columns, writable));
+        }
+
+        template <typename Container> size_t container_table<Container>::RowCount() const
+        {
+            return this->_rows->size();
+        }
+
+        template <typename Container> void container_table<Container>::Column(sqlite3_context* context, size_t index, int column) const
+        {
+            this->_columns.Column((size_t)column).Read(context, (*this->_rows)[index], this->_writable);
+        }
+
+        template <typename Container> void container_table<Container>::FindRange(int plan, sqlite3_value** values, size_t& begin, size_t& end) const
+        {
+            begin = 0u;
+            end = this->_rows->size();
+
+            int equalities = plan & plan_equality_mask;
+            sqlite3_value* lower = ((plan & plan_lower) != 0) ? values[equalities] : nullptr;
+            sqlite3_value* upper = ((plan & plan_upper) != 0) ? values[equalities + ((lower != nullptr) ? 1 : 0)] : nullptr;
+
+            // A value of another storage class is compared by SQLite, which checks each row of the full scan.
+            for (int i = 0; i < equalities; ++i)
+            {
+                if (!this->_columns.Column((size_t)this->_keyColumns[i]).Comparable(values[i]))
+                {
+                    return;
+                }
+            }
+
+            if ((lower != nullptr) && !this->_columns.Column((size_t)this->_keyColumns[equalities]).Comparable(lower))
+            {
+                lower = nullptr;
+            }
+
+            if ((upper != nullptr) && !this->_columns.Column((size_t)this->_keyColumns[equalities]).Comparable(upper))
+            {
+                upper = nullptr;
+            }
+
+            begin = this->Search(equalities, values, lower, false, (plan & plan_lower_exclusive) == 0);
+            end = this->Search(equalities, values, upper, true, (plan & plan_upper_exclusive) == 0);
+            if (end < begin)
+            {
+                end = begin;
+            }
+        }
+
+        template <typename Container> size_t container_table<Container>::Search(int equalities, sqlite3_value** values, sqlite3_value* bound, bool upper, bool inclusive) const
+        {
+            size_t first = 0u;
+            size_t count = this->_rows->size();
+            while (count > 0u)
+            {
+                size_t half = count / 2u;
+                const row_type& row = (*this->_rows)[first + half];
+
+                // Set if the row lies before the searched position.
+                bool before = upper;
+                bool decided = false;
+                for (int i = 0; (i < equalities) && !decided; ++i)
+                {
+                    int result = this->_columns.Column((size_t)this->_keyColumns[i]).Compare(row, values[i]);
+                    if (result != 0)
+                    {
+                        before = result < 0;
+                        decided = true;
+                    }
+                }
+
+                if (!decided && (bound != nullptr))
+                {
+                    int result = this->_columns.Column((size_t)this->_keyColumns[equalities]).Compare(row, bound);
+                    before = (upper == inclusive) ? (result <= 0) : (result < 0);
+                }
+
+                if (before)
+                {
+                    first += half + 1u;
+                    count -= half + 1u;
+                }
+                else
+                {
+                    count = half;
+                }
+            }
+
+            return first;
+        }
+
+        template <typename Container> int container_table<Container>::CompareKeys(const row_type& left, const row_type& right) const
+        {
+            for (int column : this->_keyColumns)
+            {
+                int result = this->_columns.Column((size_t)column).CompareRows(left, right);
+                if (result != 0)
+                {
+                    return result;
+                }
+            }
+
+            return 0;
+        }
+
+        template <typename Container> int container_table<Container>::Store(sqlite3_vtab* table, int argc, sqlite3_value** argv, sqlite3_int64* rowId)
+        {
+            return this->Store(table, argc, argv, rowId, has_push_back_erase<Container>());
+        }
+
+        template <typename Container> int container_table<Container>::Store(sqlite3_vtab* table, int /*argc*/, sqlite3_value** /*argv*/, sqlite3_int64* /*rowId*/, std::false_type)
+        {
+            return Error(table, SQLITE_READONLY, "The container table is read-only");
+        }
+
+        template <typename Container> int container_table<Container>::Store(sqlite3_vtab* table, int argc, sqlite3_value** argv, sqlite3_int64* rowId, std::true_type)
+        {
+            size_t columnCount = this->_definitions.size();
+            if ((size_t)argc != columnCount + 2u)
+            {
+                return Error(table, SQLITE_MISUSE, "Unexpected number of values");
+            }
+
+            if (sqlite3_value_type(argv[0]) == SQLITE_NULL)
+            {
+                if (sqlite3_value_type(argv[1]) != SQLITE_NULL)
+                {
+                    return Error(table, SQLITE_CONSTRAINT, "The row id of a container table cannot be set");
+                }
+
+                row_type row = row_type();
+                int rc = this->WriteColumns(table, row, nullptr, argv + 2);
+                if (rc != SQLITE_OK)
+                {
+                    return rc;
+                }
+
+                if (!this->_keyColumns.empty() && !this->_rows->empty() && (this->CompareKeys(this->_rows->back(), row) > 0))
+                {
+                    return Error(table, SQLITE_CONSTRAINT, "Rows must be inserted in the order of the sorted key");
+                }
+
+                this->_rows->push_back(std::move(row));
+                *rowId = (sqlite3_int64)(this->_rows->size() - 1u);
+                return SQLITE_OK;
+            }
+
+            sqlite3_int64 index = sqlite3_value_int64(argv[0]);
+            if (sqlite3_value_int64(argv[1]) != index)
+            {
+                return Error(table, SQLITE_CONSTRAINT, "The row id of a container table cannot be changed");
+            }
+
+            if ((index < 0) || ((size_t)index >= this->_rows->size()) || this->IsDeleted((size_t)index))
+            {
+                return Error(table, SQLITE_ERROR, "The row does not exist");
+            }
+
+            // The row is changed in a copy, so it stays unchanged if a key column would change.
+            row_type& target = (*this->_rows)[(size_t)index];
+            row_type row = target;
+            int rc = this->WriteColumns(table, row, &target, argv + 2);
+            if (rc != SQLITE_OK)
+            {
+                return rc;
+            }
+
+            if (this->CompareKeys(target, row) != 0)
+            {
+                return Error(table, SQLITE_CONSTRAINT, "The sorted key of a container table cannot be changed");
+            }
+
+            target = std::move(row);
+            return SQLITE_OK;
+        }
+
+        template <typename Container> int container_table<Container>::WriteColumns(sqlite3_vtab* table, row_type& row, const row_type* current, sqlite3_value** values)
+        {
+            size_t columnCount = this->_definitions.size();
+            std::vector<size_t> readOnly;
+            for (size_t i = 0u; i < columnCount; ++i)
+            {
+                if (!IsNoChange(values[i]) && !this->_columns.Column(i).Write(row, values[i]))
+                {
+                    readOnly.push_back(i);
+                }
+            }
+
+            // A computed or view column accepts only its own value: the current one for an update, or the one that
+            // follows from the other columns for an insert, where NULL stands for a column that was not given.
+            for (size_t i : readOnly)
+            {
+                const table_column<row_type>& column = this->_columns.Column(i);
+                if ((nullptr == current) && (sqlite3_value_type(values[i]) == SQLITE_NULL))
+                {
+                    continue;
+                }
+
+                const row_type& compared = (nullptr == current) ? row : *current;
+                if (!column.Comparable(values[i]) || (column.Compare(compared, values[i]) != 0))
+                {
+                    std::string message = "Column " + this->_definitions[i].name + " of a container table cannot be written";
+                    return Error(table, SQLITE_CONSTRAINT, message.c_str());
+                }
+            }
+
+            return SQLITE_OK;
+        }
+
+        template <typename Container> void container_table<Container>::Compact()
+        {
+            this->Compact(has_push_back_erase<Container>());
+        }
+
+        template <typename Container> void container_table<Container>::Compact(std::false_type)
+        {
+        }
+
+        template <typename Container> void container_table<Container>::Compact(std::true_type)
+        {
+            if (this->_deletedCount == 0u)
+            {
+                return;
+            }
+
+            // Moves the remaining rows to the front in their order, so the container stays sorted.
+            size_t count = this->_rows->size();
+            size_t kept = 0u;
+            for (size_t i = 0u; i < count; ++i)
+            {
+                if (!this->IsDeleted(i))
+                {
+                    if (kept != i)
+                    {
+                        (*this->_rows)[kept] = std::move((*this->_rows)[i]);
+                    }
+
+                    ++kept;
+                }
+            }
+
+            this->_rows->erase(this->_rows->begin() + (std::ptrdiff_t)kept, this->_rows->end());
+            this->_deleted.clear();
+            this->_deletedCount = 0u;
+        }
+
+        template <typename Container> void CreateContainerTable(sqlite& dbObject, const std::string& name, Container& rows, const table_columns<typename std::remove_const<typename Container::value_type>::type>& columns, bool writable)
+        {
+            container_table<Container>::Create(dbObject, name, rows, columns, writable);
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // CONTAINER_TABLE_BB0AB32CCFEF460D816674433F5C255D
@@ -1,4 +1,7 @@
 #include "exec_result.hpp"
+#include <cstring>
+#include <new>
+#include <utility>
 
 namespace sqlitelib
 {
@@ -9,14 +12,85 @@ namespace sqlitelib
         using std::vector;
 
         exec_result::exec_result()
-            :   _returnColumnNames(true)
+            :   exec_result(false)
         {
         }
 
+        exec_result::exec_result(bool useArena)
+            :   _returnColumnNames(true),
+                _useArena(useArena),
+                _arena(),
+                _rows(),
+                _fieldNames(nullptr),
+                _fieldCount(0u),
+                _indexAllocations(0u)
+        {
+        }
+
+        exec_result::exec_result(const exec_result& src)
+            :   _returnColumnNames(src._returnColumnNames),
+                _useArena(src._useArena),
+                _arena(),
+                _rows(),
+                _fieldNames(nullptr),
+                _fieldCount(0u),
+                _indexAllocations(0u)
+        {
+            this->CopyRows(src);
+        }
+
+        exec_result::exec_result(exec_result&& src)
+            :   _returnColumnNames(src._returnColumnNames),
+                _useArena(src._useArena),
+                _arena(std::move(src._arena)),
+                _rows(std::move(src._rows)),
+                _fieldNames(src._fieldNames),
+                _fieldCount(src._fieldCount),
+                _indexAllocations(src._indexAllocations)
+        {
+            // The blocks of the arena moved, so the names no longer belong to the source.
+            src._rows.clear();
+            src._fieldNames = nullptr;
+            src._fieldCount = 0u;
+        }
+
         exec_result::~exec_result()
         {
         }
 
+        exec_result& exec_result::operator=(const exec_result& src)
+        {
+            if (this != &src)
+            {
+                this->_returnColumnNames = src._returnColumnNames;
+                this->_useArena = src._useArena;
+                this->ClearRows();
+                this->CopyRows(src);
+            }
+
+            return *this;
+        }
+
+        exec_result& exec_result::operator=(exec_result&& src)
+        {
+            if (this != &src)
+            {
+                this->_returnColumnNames = src._returnColumnNames;
+                this->_useArena = src._useArena;
+                this->_arena = std::move(src._arena);
+                this->_rows = std::move(src._rows);
+                this->_fieldNames = src._fieldNames;
+                this->_fieldCount = src._fieldCount;
+                this->_indexAllocations = src._indexAllocations;
+
+                src._rows.clear();
+                src._fieldNames = nullptr;
+                src._fieldCount = 0u;
+            }
+
+            return *this;
+        }
+
         bool exec_result::RowData(const std::vector<std::pair<std::string,  std::string > >& values)
         {
             this->_returnColumnNames = false;
@@ -27,5 +101,157 @@ namespace sqlitelib
         {
             return true;
         }
+
+        bool exec_result::RowData(const arena_row& /*row*/)
+        {
+            return true;
+        }
+
+        /**
+         * @brief Copy a string into an arena.
+         * @param arena Arena that receives the copy.
+         * @param text Zero-terminated string, or \c nullptr.
+         * @returns Returns a view on the copy, or an empty view with a \c nullptr data pointer for \c nullptr.
+         */
+        static text_view CopyToArena(row_arena& arena, const char* text)
+        {
+            if (nullptr == text)
+            {
+                return text_view();
+            }
+
+            size_t length = std::strlen(text);
+            char* copyPtr = (char*)arena.Allocate(length + 1u, 1u);
+            std::memcpy(copyPtr, text, length + 1u);
+            return text_view(copyPtr, length);
+        }
+
+        /**
+         * @brief Copy a string that is stored in an arena, including its terminating zero, into another arena.
+         * @param arena Arena that receives the copy.
+         * @param text View on the stored string, or an empty view with a \c nullptr data pointer.
+         * @returns Returns a view on the copy, or an empty view with a \c nullptr data pointer.
+         */
+        static text_view CopyToArena(row_arena& arena, text_view text)
+        {
+            if (nullptr == text.data())
+            {
+                return text_view();
+            }
+
+            char* copyPtr = (char*)arena.Allocate(text.size() + 1u, 1u);
+            std::memcpy(copyPtr, text.data(), text.size() + 1u);
+            return text_view(copyPtr, text.size());
+        }
+
+        bool exec_result::SameFieldNames(size_t fieldCount, char** fieldNames) const
+        {
+            if ((nullptr == this->_fieldNames) || (fieldCount != this->_fieldCount))
+            {
+                return false;
+            }
+
+            for (size_t index = 0u; index < fieldCount; ++index)
+            {
+                if (std::strcmp(this->_fieldNames[index].data(), fieldNames[index]) != 0)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        bool exec_result::StoreRow(size_t fieldCount, char** fieldNames, char** fieldValues)
+        {
+            if (!this->SameFieldNames(fieldCount, fieldNames))
+            {
+                // New result set: the column names are copied once and shared by its rows.
+                text_view* namesPtr = (text_view*)this->_arena.Allocate(fieldCount * sizeof(text_view), alignof(text_view));
+                for (size_t index = 0u; index < fieldCount; ++index)
+                {
+                    new (namesPtr + index) text_view(CopyToArena(this->_arena, fieldNames[index]));
+                }
+
+                this->_fieldNames = namesPtr;
+                this->_fieldCount = fieldCount;
+            }
+
+            arena_field* fieldsPtr = (arena_field*)this->_arena.Allocate(fieldCount * sizeof(arena_field), alignof(arena_field));
+            for (size_t index = 0u; index < fieldCount; ++index)
+            {
+                arena_field* fieldPtr = new (fieldsPtr + index) arena_field();
+                fieldPtr->name = this->_fieldNames[index];
+                fieldPtr->value = CopyToArena(this->_arena, fieldValues[index]);
+            }
+
+            if (this->_rows.size() == this->_rows.capacity())
+            {
+                ++this->_indexAllocations;
+            }
+
+            this->_rows.push_back(arena_row(fieldsPtr, fieldCount));
+            return this->RowData(this->_rows.back());
+        }
+
+        void exec_result::CopyRows(const exec_result& src)
+        {
+            if (this->_rows.capacity() < this->_rows.size() + src._rows.size())
+            {
+                this->_rows.reserve(this->_rows.size() + src._rows.size());
+                ++this->_indexAllocations;
+            }
+
+            // Rows of one result set share their names, so the names are copied once per result set.
+            const arena_field* sourceNames = nullptr;
+            const arena_field* copiedNames = nullptr;
+
+            for (const arena_row& row : src._rows)
+            {
+                size_t fieldCount = row.size();
+                arena_field* fieldsPtr = (arena_field*)this->_arena.Allocate(fieldCount * sizeof(arena_field), alignof(arena_field));
+                bool sameNames = (nullptr != sourceNames) && (fieldCount > 0u) && (row[0].name.data() == sourceNames[0].name.data());
+
+                for (size_t index = 0u; index < fieldCount; ++index)
+                {
+                    arena_field* fieldPtr = new (fieldsPtr + index) arena_field();
+                    fieldPtr->name = sameNames ? copiedNames[index].name : CopyToArena(this->_arena, row[index].name);
+                    fieldPtr->value = CopyToArena(this->_arena, row[index].value);
+                }
+
+                if (!sameNames && (fieldCount > 0u))
+                {
+                    sourceNames = row.begin();
+                    copiedNames = fieldsPtr;
+                }
+
+                this->_rows.push_back(arena_row(fieldsPtr, fieldCount));
+            }
+
+            // The next row stored by sqlite::Exec() copies its names again.
+            this->_fieldNames = nullptr;
+            this->_fieldCount = 0u;
+        }
+
+        void exec_result::ClearRows()
+        {
+            this->_rows.clear();
+            this->_arena.Reset();
+
+            // The names of the current result set were released with the arena.
+            this->_fieldNames = nullptr;
+            this->_fieldCount = 0u;
+        }
+
+        exec_arena_stats exec_result::ArenaStats() const
+        {
+            exec_arena_stats result;
+            result.blockAllocations = this->_arena.BlockAllocations();
+            result.indexAllocations = this->_indexAllocations;
+            result.bytesUsed = this->_arena.BytesUsed();
+            result.bytesReserved = this->_arena.BytesReserved();
+            result.rowCount = this->_rows.size();
+            return result;
+        }
     } // namespace SQLite3
 } // namespace sqlitelib
@@ -1,20 +1,50 @@
 #if !defined EXEC_RESULT_BB0AB32CCFEF460D816674433F5C255D
 #define EXEC_RESULT_BB0AB32CCFEF460D816674433F5C255D
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <string>
+#include "row_arena.hpp"
 
 namespace sqlitelib
 {
     namespace SQLite3
     {
+        class sqlite;
+
+        /**
+         * @brief Allocation counters of the arena of an exec_result.
+         */
+        struct exec_arena_stats
+        {
+            uint64_t blockAllocations;  ///< Number of arena blocks allocated from the heap.
+            uint64_t indexAllocations;  ///< Number of times the row index had to grow.
+            size_t bytesUsed;           ///< Number of arena bytes used by the stored rows.
+            size_t bytesReserved;       ///< Total size of the arena blocks.
+            size_t rowCount;            ///< Number of stored rows.
+        }; // struct exec_arena_stats
+
         /**
          * @brief class to handle output from sqlite3_exec.
+         * @details In arena mode the fields of each row are copied into a row_arena instead of into new string objects,
+         * and passed to \c RowData(const arena_row&). The rows are kept until ClearRows() is called, which releases them
+         * in one shot.
          */
         class exec_result
         {
+            friend class sqlite;
+
             protected:
                 bool _returnColumnNames; ///< Flag to control if column names must be returned
+                bool _useArena; ///< Flag to control if rows are stored in the arena.
+
+            private:
+                row_arena _arena; ///< Storage of the field names and values in arena mode.
+                std::vector<arena_row> _rows; ///< Rows that are stored in the arena.
+                const text_view* _fieldNames; ///< Column names of the current result set, stored in the arena.
+                size_t _fieldCount; ///< Number of columns of the current result set.
+                uint64_t _indexAllocations; ///< Number of times \c _rows had to grow.
 
             public:
                 /**
@@ -22,11 +52,42 @@ namespace sqlitelib
                  */
                 exec_result();
 
+                /**
+                 * @brief Construct an object that optionally stores rows in an arena.
+                 * @param useArena \c true to store rows in the arena and call \c RowData(const arena_row&).
+                 */
+                explicit exec_result(bool useArena);
+
+                /**
+                 * @brief Copy constructor. The stored rows are copied into a new arena.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                exec_result(const exec_result& src);
+
+                /**
+                 * @brief Move constructor. The stored rows and their arena are taken over.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                exec_result(exec_result&& src);
+
                 /**
                  * @brief Destructor.
                  */
                 virtual ~exec_result();
 
+            public:
+                /**
+                 * @brief Copy assignment operator. The stored rows are copied into the arena of this object.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                exec_result& operator=(const exec_result& src);
+
+                /**
+                 * @brief Move assignment operator. The stored rows and their arena are taken over.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                exec_result& operator=(exec_result&& src);
+
             public:
                 /**
                  * @brief Must indicate if the callback function of sqlite3_exec() returns field names or not.
@@ -35,6 +96,13 @@ namespace sqlitelib
                  */
                 inline bool ReturnFieldNames() const;
 
+                /**
+                 * @brief Must indicate if rows are stored in the arena.
+                 * @retval true Rows are passed to \c RowData(const arena_row&).
+                 * @retval false Rows are passed as vectors of strings.
+                 */
+                inline bool UseArena() const;
+
                 /**
                  * @brief This method is called when \c ReturnFieldNames() returns \c true. 
                  * 
@@ -46,12 +114,71 @@ namespace sqlitelib
                  * 
                  */
                 virtual bool RowData(const std::vector<std::string>& values);
+
+                /**
+                 * @brief This method is called in arena mode after a row has been stored.
+                 * @param row The stored row. It stays valid until ClearRows() is called.
+                 * @retval true Continue retrieving records.
+                 * @retval false Abort retrieval.
+                 */
+                virtual bool RowData(const arena_row& row);
+
+                /**
+                 * @brief Get the rows that are stored in the arena.
+                 */
+                inline const std::vector<arena_row>& Rows() const;
+
+                /**
+                 * @brief Release all stored rows in one shot. The arena memory is kept for the next rows.
+                 */
+                void ClearRows();
+
+                /**
+                 * @brief Get the allocation counters of the arena.
+                 * @returns Returns a snapshot of the counters.
+                 */
+                exec_arena_stats ArenaStats() const;
+
+            private:
+                /**
+                 * @brief Called by sqlite::Exec() to copy the fields of a row into the arena and pass the row to
+                 * \c RowData(const arena_row&).
+                 * @param fieldCount Number of fields.
+                 * @param fieldNames Names of the fields.
+                 * @param fieldValues Values of the fields. \c NULL values are \c nullptr.
+                 * @retval true Continue retrieving records.
+                 * @retval false Abort retrieval.
+                 */
+                bool StoreRow(size_t fieldCount, char** fieldNames, char** fieldValues);
+
+                /**
+                 * @brief Copy the stored rows of another object into the arena, after the rows of this object.
+                 * @param src The object whose rows are copied.
+                 */
+                void CopyRows(const exec_result& src);
+
+                /**
+                 * @brief Check if the column names match those of the rows stored before.
+                 * @param fieldCount Number of fields.
+                 * @param fieldNames Names of the fields.
+                 */
+                bool SameFieldNames(size_t fieldCount, char** fieldNames) const;
         };
 
         inline bool exec_result::ReturnFieldNames() const
         {
             return this->_returnColumnNames;
         }
+
+        inline bool exec_result::UseArena() const
+        {
+            return this->_useArena;
+        }
+
+        inline const std::vector<arena_row>& exec_result::Rows() const
+        {
+            return this->_rows;
+        }
     } // namespace SQLite3
 } // namespace sqlitelib
 #endif // EXEC_RESULT_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,25 @@
+#include "exec_stream.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        exec_stream::exec_stream()
+        {
+        }
+
+        exec_stream::~exec_stream()
+        {
+        }
+
+        void exec_stream::ResultStart(const std::vector<text_view>& /*columnNames*/)
+        {
+            // Do nothing.
+        }
+
+        void exec_stream::ResultEnd()
+        {
+            // Do nothing.
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
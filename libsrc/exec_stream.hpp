@@ -0,0 +1,52 @@
+#if !defined EXEC_STREAM_BB0AB32CCFEF460D816674433F5C255D
+#define EXEC_STREAM_BB0AB32CCFEF460D816674433F5C255D
+
+#include <vector>
+#include "column_view.hpp"
+#include "row_iterator.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Class to handle typed output from sqlite::Exec(const std::string&, exec_stream&).
+         * @details Unlike exec_result, values are not converted to text: each row is passed as a result_row with typed,
+         * zero-copy accessors, and the column names are passed once per result set.
+         */
+        class exec_stream
+        {
+            public:
+                /**
+                 * @brief Default constructor.
+                 */
+                exec_stream();
+
+                /**
+                 * @brief Destructor.
+                 */
+                virtual ~exec_stream();
+
+            public:
+                /**
+                 * @brief Called before the first row of each statement that returns columns.
+                 * @param columnNames Names of the columns, valid until ResultEnd() is called.
+                 */
+                virtual void ResultStart(const std::vector<text_view>& columnNames);
+
+                /**
+                 * @brief Called for each row.
+                 * @param row The current row. Its values are only valid during the call.
+                 * @retval true Continue retrieving records.
+                 * @retval false Stop executing the SQL statements.
+                 */
+                virtual bool RowData(const result_row& row) = 0;
+
+                /**
+                 * @brief Called after the last row of each statement that returns columns.
+                 */
+                virtual void ResultEnd();
+        };
+    } // namespace SQLite3
+} // namespace sqlitelib
+#endif // EXEC_STREAM_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,237 @@
+#if !defined GENERATOR_BB0AB32CCFEF460D816674433F5C255D
+#define GENERATOR_BB0AB32CCFEF460D816674433F5C255D
+
+// Coroutine support needs a C++20 compiler. With older toolsets, prepared_statement::Rows() offers the same lazy,
+// pull-based row access through iterators.
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L)
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "async_executor.hpp"
+#include "prepared_statement.hpp"
+#include "row_iterator.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Lazily evaluated sequence of values produced by a coroutine with \c co_yield.
+         * @details The coroutine runs only while the consumer advances the iterator, so several generators can be
+         * interleaved on one thread and a consumer can stop early by leaving the loop. Exceptions thrown by the
+         * coroutine are rethrown to the consumer.
+         */
+        template <typename T> class generator
+        {
+            public:
+                using value_type = std::remove_cv_t< std::remove_reference_t<T> >;
+                using reference = std::conditional_t<std::is_reference_v<T>, T, const value_type&>; ///< A generator of values hands out const references.
+                using pointer = std::add_pointer_t<reference>;
+
+                /**
+                 * @brief Promise type of the coroutine.
+                 */
+                class promise_type
+                {
+                    friend class generator;
+
+                    private:
+                        pointer _current;           ///< Value of the last \c co_yield.
+                        std::exception_ptr _error;  ///< Exception that escaped the coroutine.
+
+                    public:
+                        generator get_return_object() { return generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+                        std::suspend_always initial_suspend() noexcept { return {}; }
+                        std::suspend_always final_suspend() noexcept { return {}; }
+                        void return_void() noexcept {}
+                        void unhandled_exception() noexcept { this->_error = std::current_exception(); }
+
+                        /**
+                         * @brief Suspend the coroutine at a \c co_yield. The value lives in the coroutine frame until it
+                         * is resumed, so only its address is kept. For a generator of values, a const or converted
+                         * value binds to a temporary that also lives until the coroutine is resumed.
+                         */
+                        std::suspend_always yield_value(reference value) noexcept
+                        {
+                            this->_current = std::addressof(value);
+                            return {};
+                        }
+
+                        // co_await is not allowed in a generator.
+                        template <typename U> std::suspend_never await_transform(U&&) = delete;
+                };
+
+                /**
+                 * @brief Input iterator over the values of the generator.
+                 */
+                class iterator
+                {
+                    private:
+                        std::coroutine_handle<promise_type> _handle; ///< The coroutine, or an empty handle at the end.
+
+                    public:
+                        using iterator_category = std::input_iterator_tag;
+                        using difference_type = std::ptrdiff_t;
+                        using value_type = typename generator::value_type;
+                        using reference = typename generator::reference;
+                        using pointer = typename generator::pointer;
+
+                        iterator() noexcept : _handle() {}
+                        explicit iterator(std::coroutine_handle<promise_type> handle) : _handle(handle) { this->Resume(); }
+
+                        reference operator*() const { return static_cast<reference>(*this->_handle.promise()._current); }
+                        pointer operator->() const { return this->_handle.promise()._current; }
+                        iterator& operator++() { this->Resume(); return *this; }
+                        bool operator==(const iterator& other) const noexcept { return this->_handle == other._handle; }
+                        bool operator!=(const iterator& other) const noexcept { return this->_handle != other._handle; }
+
+                    private:
+                        /**
+                         * @brief Run the coroutine to its next \c co_yield and move to the end when it finishes.
+                         */
+                        void Resume()
+                        {
+                            this->_handle.resume();
+                            if (this->_handle.done())
+                            {
+                                std::exception_ptr error = this->_handle.promise()._error;
+                                this->_handle = nullptr;
+                                if (error)
+                                {
+                                    std::rethrow_exception(error);
+                                }
+                            }
+                        }
+                };
+
+            private:
+                std::coroutine_handle<promise_type> _handle; ///< The coroutine.
+
+            private:
+                explicit generator(std::coroutine_handle<promise_type> handle) noexcept : _handle(handle) {}
+
+            public:
+                generator(const generator& src) = delete;
+                generator(generator&& src) noexcept : _handle(std::exchange(src._handle, nullptr)) {}
+
+                /**
+                 * @brief Destructor. Destroys the coroutine frame, also if the sequence was not consumed to its end.
+                 */
+                ~generator()
+                {
+                    if (this->_handle)
+                    {
+                        this->_handle.destroy();
+                    }
+                }
+
+                generator& operator=(const generator& src) = delete;
+
+                generator& operator=(generator&& src) noexcept
+                {
+                    std::swap(this->_handle, src._handle);
+                    return *this;
+                }
+
+            public:
+                /**
+                 * @brief Start the coroutine. May only be called once.
+                 * @returns Returns an iterator on the first value.
+                 */
+                iterator begin() { return iterator(this->_handle); }
+
+                /**
+                 * @brief Get the end iterator.
+                 */
+                iterator end() noexcept { return iterator(); }
+        }; // class generator
+
+        /**
+         * @brief Produce the rows of a statement lazily.
+         * @param statement The statement, which must outlive the generator. Reset it to run it again after stopping early.
+         * @returns Returns a generator that steps the statement each time it is advanced.
+         */
+        inline generator<const result_row&> GenerateRows(prepared_statement& statement)
+        {
+            for (const result_row& row : statement.Rows())
+            {
+                co_yield row;
+            }
+        }
+
+        /**
+         * @brief Awaitable that runs a function on a worker of an async_executor.
+         * @details The awaiting coroutine is suspended while the function runs, and is resumed on the worker thread
+         * when it has finished.
+         */
+        template <typename Function> class executor_awaitable
+        {
+            private:
+                using result_type = std::invoke_result_t<Function&, sqlite&>;
+                using storage_type = std::conditional_t<std::is_void_v<result_type>, char, result_type>;
+
+            private:
+                async_executor& _executor;          ///< Executor that runs the function.
+                Function _function;                 ///< The function.
+                std::unique_ptr<storage_type> _result; ///< Result of the function.
+                std::exception_ptr _error;          ///< Exception thrown by the function.
+
+            public:
+                executor_awaitable(async_executor& executor, Function function) : _executor(executor), _function(std::move(function)), _result(), _error() {}
+
+                bool await_ready() const noexcept { return false; }
+
+                void await_suspend(std::coroutine_handle<> handle)
+                {
+                    this->_executor.Post([this](sqlite& connection)
+                    {
+                        if constexpr (std::is_void_v<result_type>)
+                        {
+                            this->_function(connection);
+                        }
+                        else
+                        {
+                            this->_result.reset(new storage_type(this->_function(connection)));
+                        }
+                    },
+                    [this, handle](std::exception_ptr error)
+                    {
+                        this->_error = error;
+                        handle.resume();
+                    });
+                }
+
+                result_type await_resume()
+                {
+                    if (this->_error)
+                    {
+                        std::rethrow_exception(this->_error);
+                    }
+
+                    if constexpr (!std::is_void_v<result_type>)
+                    {
+                        return std::move(*this->_result);
+                    }
+                }
+        }; // class executor_awaitable
+
+        /**
+         * @brief Run a function on a worker of an async_executor from a coroutine: \c co_await \c RunOn(executor, f).
+         * @param executor Executor that runs the function.
+         * @param function Callable object that takes a \c sqlite&.
+         * @returns Returns an awaitable that produces the result of the function.
+         */
+        template <typename Function> executor_awaitable< std::decay_t<Function> > RunOn(async_executor& executor, Function&& function)
+        {
+            return executor_awaitable< std::decay_t<Function> >(executor, std::forward<Function>(function));
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // __cpp_impl_coroutine
+
+#endif // GENERATOR_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,46 @@
+#if !defined OPEN_OPTIONS_BB0AB32CCFEF460D816674433F5C255D
+#define OPEN_OPTIONS_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sqlite3.h>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Settings that are applied to a connection when it is opened.
+         */
+        struct open_options
+        {
+            static const size_t DefaultStatementCacheCapacity = 32u; ///< Capacity of the statement cache of a connection that is opened without options.
+
+            int flags;                     ///< File open flags passed to \c sqlite3_open_v2().
+            int64_t mmapSize;              ///< Value for \c PRAGMA \c mmap_size, the number of bytes of the file that are accessed through memory-mapped I/O. Negative keeps the default.
+            int64_t cacheSize;             ///< Value for \c PRAGMA \c cache_size, in pages if positive or in KiB if negative. Zero keeps the default.
+            std::string tempStore;         ///< Value for \c PRAGMA \c temp_store, e.g. \c "MEMORY". Empty keeps the default.
+            std::string lockingMode;       ///< Value for \c PRAGMA \c locking_mode, e.g. \c "EXCLUSIVE". Empty keeps the default.
+            size_t statementCacheCapacity; ///< Maximum number of statements kept by the statement cache. Zero disables caching.
+
+            /**
+             * @brief Construct the default settings: open for reading and writing, create the file if it does not
+             * exist, leave the pragmas unchanged and cache up to DefaultStatementCacheCapacity statements.
+             */
+            inline open_options();
+        }; // struct open_options
+
+        inline open_options::open_options()
+            :   flags(SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE),
+                mmapSize(-1),
+                cacheSize(0),
+                tempStore(),
+                lockingMode(),
+                statementCacheCapacity(DefaultStatementCacheCapacity)
+        {
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // OPEN_OPTIONS_BB0AB32CCFEF460D816674433F5C255D
@@ -10,7 +10,11 @@ namespace sqlitelib
         using std::wstring;
 
         prepared_statement::prepared_statement(sqlite& dbObject, const string& sql)
-            :   _statementPtr(nullptr)
+            :   _statementPtr(nullptr),
+                _boundText(),
+                _boundBlobs(),
+                _batchEnd(false),
+                _finalizedStatus(dbObject._finalizedStatus)
         {
             sqlite3_stmt* statementPtr;
             int rc = sqlite3_prepare_v2
@@ -33,6 +37,15 @@ namespace sqlitelib
 
         prepared_statement::~prepared_statement()
         {
+            if ((this->_statementPtr != nullptr) && this->_finalizedStatus)
+            {
+                statement_status status = statement_status::Read(this->_statementPtr, false);
+
+                // The memory of the statement is released, so it does not add to the total.
+                status.memoryUsed = 0u;
+                *this->_finalizedStatus += status;
+            }
+
             sqlite3_finalize(this->_statementPtr);
             this->_statementPtr = nullptr;
         }
@@ -55,6 +68,21 @@ namespace sqlitelib
             }
         }
 
+        void prepared_statement::Bind(int paramIndex, std::vector<uint8_t>&& blob)
+        {
+            vector<uint8_t>& slot = this->OwnedParameterSlot(this->_boundBlobs, paramIndex);
+            vector<uint8_t> previous(std::move(slot));
+            slot = std::move(blob);
+
+            int rc = sqlite3_bind_blob64(this->_statementPtr, paramIndex, (const void*)slot.data(), (sqlite_int64)slot.size(), SQLITE_STATIC);
+            if (rc != SQLITE_OK)
+            {
+                // The previous value may still be bound.
+                slot = std::move(previous);
+                throw sqlite_exception(rc);
+            }
+        }
+
         void prepared_statement::Bind(int paramIndex, double value)
         {
             int rc = sqlite3_bind_double(this->_statementPtr, paramIndex, value);
@@ -91,6 +119,21 @@ namespace sqlitelib
             }
         }
 
+        void prepared_statement::Bind(int paramIndex, std::string&& value)
+        {
+            string& slot = this->OwnedParameterSlot(this->_boundText, paramIndex);
+            string previous(std::move(slot));
+            slot = std::move(value);
+
+            int rc = sqlite3_bind_text64(this->_statementPtr, paramIndex, slot.c_str(), (sqlite_int64)slot.size(), SQLITE_STATIC, SQLITE_UTF8);
+            if (rc != SQLITE_OK)
+            {
+                // The previous value may still be bound.
+                slot = std::move(previous);
+                throw sqlite_exception(rc);
+            }
+        }
+
         void prepared_statement::Bind(int paramIndex, const std::wstring& value)
         {
             int rc = sqlite3_bind_text16
@@ -116,6 +159,24 @@ namespace sqlitelib
             }
         }
 
+        void prepared_statement::BindStatic(int paramIndex, text_view value)
+        {
+            int rc = sqlite3_bind_text64(this->_statementPtr, paramIndex, value.data(), (sqlite_int64)value.size(), SQLITE_STATIC, SQLITE_UTF8);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc);
+            }
+        }
+
+        void prepared_statement::BindStatic(int paramIndex, blob_span blob)
+        {
+            int rc = sqlite3_bind_blob64(this->_statementPtr, paramIndex, (const void*)blob.data(), (sqlite_int64)blob.size(), SQLITE_STATIC);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc);
+            }
+        }
+
         void prepared_statement::ClearBindings()
         {
             int rc = sqlite3_clear_bindings(this->_statementPtr);
@@ -123,10 +184,23 @@ namespace sqlitelib
             {
                 throw sqlite_exception(rc);
             }
+
+            // The slots are not resized, so bound values never move while the statement refers to them.
+            for (string& text : this->_boundText)
+            {
+                string().swap(text);
+            }
+
+            for (vector<uint8_t>& blob : this->_boundBlobs)
+            {
+                vector<uint8_t>().swap(blob);
+            }
         }
 
         void prepared_statement::Reset()
         {
+            this->_batchEnd = false;
+
             int rc = sqlite3_reset(this->_statementPtr);
             if (rc != SQLITE_OK)
             {
@@ -197,6 +271,58 @@ namespace sqlitelib
             processor.Completed(*this);
         }
 
+        void prepared_statement::Execute()
+        {
+            int returnCode;
+            do
+            {
+                returnCode = sqlite3_step(this->_statementPtr);
+            }
+            while (returnCode == SQLITE_ROW);
+
+            if (returnCode != SQLITE_DONE)
+            {
+                throw sqlite_exception(returnCode, sqlite3_errmsg(sqlite3_db_handle(this->_statementPtr)));
+            }
+        }
+
+        size_t prepared_statement::FetchBatch(column_batch& batch)
+        {
+            if (batch.ColumnsCount() > this->ResultColumnsCount())
+            {
+                throw sqlite_exception(SQLITE_RANGE, "The batch has more columns than the statement.");
+            }
+
+            batch.Clear();
+
+            if (this->_batchEnd)
+            {
+                // sqlite3_step() would reset the statement and run the query again.
+                batch._endOfResult = true;
+                return 0u;
+            }
+
+            while (batch.RowCount() < batch.Capacity())
+            {
+                int returnCode = sqlite3_step(this->_statementPtr);
+                if (returnCode == SQLITE_DONE)
+                {
+                    this->_batchEnd = true;
+                    batch._endOfResult = true;
+                    break;
+                }
+
+                if (returnCode != SQLITE_ROW)
+                {
+                    throw sqlite_exception(returnCode, sqlite3_errmsg(sqlite3_db_handle(this->_statementPtr)));
+                }
+
+                batch.StoreRow(this->_statementPtr);
+            }
+
+            return batch.RowCount();
+        }
+
         int prepared_statement::GetInt(int index)
         {
             return sqlite3_column_int(this->_statementPtr, index);
@@ -209,24 +335,40 @@ namespace sqlitelib
 
         std::string prepared_statement::GetString(int index)
         {
-            size_t resultLength = (size_t)(sqlite3_column_bytes(this->_statementPtr, index));
-            return std::string((const char*)sqlite3_column_text(this->_statementPtr, index), resultLength);
+            return this->GetStringView(index).ToString();
         }
 
         std::wstring prepared_statement::GetWString(int index)
         {
-            size_t resultLength = (size_t)(sqlite3_column_bytes16(this->_statementPtr, index));
-            return std::wstring((const wchar_t*)sqlite3_column_text16(this->_statementPtr, index), resultLength);
+            u16text_view text = this->GetWStringView(index);
+            return std::wstring(text.begin(), text.end());
         }
 
         vector<uint8_t> prepared_statement::GetBlob(int index)
         {
-            vector<uint8_t> result;
+            return this->GetBlobSpan(index).ToVector();
+        }
+
+        text_view prepared_statement::GetStringView(int index)
+        {
+            // The pointer must be fetched before the size, because sqlite3_column_text() may convert the value.
+            const char* textPtr = (const char*)sqlite3_column_text(this->_statementPtr, index);
+            size_t resultLength = (size_t)(sqlite3_column_bytes(this->_statementPtr, index));
+            return text_view(textPtr, resultLength);
+        }
+
+        u16text_view prepared_statement::GetWStringView(int index)
+        {
+            const char16_t* textPtr = (const char16_t*)sqlite3_column_text16(this->_statementPtr, index);
+            size_t resultLength = (size_t)(sqlite3_column_bytes16(this->_statementPtr, index)) / sizeof(char16_t);
+            return u16text_view(textPtr, resultLength);
+        }
+
+        blob_span prepared_statement::GetBlobSpan(int index)
+        {
+            const uint8_t* blobPtr = (const uint8_t*)sqlite3_column_blob(this->_statementPtr, index);
             size_t resultLength = (size_t)(sqlite3_column_bytes(this->_statementPtr, index));
-            result.reserve(resultLength);
-            uint8_t* blobPtr = (uint8_t*)sqlite3_column_blob(this->_statementPtr, index);
-            result.assign(blobPtr, blobPtr + resultLength);
-            return std::move(result);
+            return blob_span(blobPtr, resultLength);
         }
 
         double prepared_statement::GetDouble(int index)
@@ -275,9 +417,36 @@ namespace sqlitelib
             return sqlite3_data_count(this->_statementPtr);
         }
 
+        int prepared_statement::ResultColumnsCount()
+        {
+            return sqlite3_column_count(this->_statementPtr);
+        }
+
         string prepared_statement::ExpandedSql()
         {
             return string(sqlite3_expanded_sql(this->_statementPtr));
         }
+
+        statement_status prepared_statement::Status(bool reset)
+        {
+            return statement_status::Read(this->_statementPtr, reset);
+        }
+
+        template <typename T> T& prepared_statement::OwnedParameterSlot(vector<T>& slots, int paramIndex)
+        {
+            int paramCount = this->ParametersCount();
+            if ((paramIndex < 1) || (paramIndex > paramCount))
+            {
+                throw sqlite_exception(SQLITE_RANGE);
+            }
+
+            if (slots.empty())
+            {
+                // Sized once, so the slots never move while SQLite refers to their contents.
+                slots.resize((size_t)paramCount + 1u);
+            }
+
+            return slots[(size_t)paramIndex];
+        }
     } // namespace SQLite3
 } // namespace sqlitelib
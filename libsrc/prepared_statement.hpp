@@ -2,10 +2,15 @@
 #define PREPARED_STATEMENT_BB0AB32CCFEF460D816674433F5C255D
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <sqlite3.h>
+#include "column_batch.hpp"
+#include "column_view.hpp"
+#include "row_iterator.hpp"
 #include "sqlite.hpp"
+#include "statement_status.hpp"
 #include "StepStatementProcessing.hpp"
 
 namespace sqlitelib
@@ -20,6 +25,10 @@ namespace sqlitelib
         {
             private:
                 sqlite3_stmt* _statementPtr; ///< Handle of the prepared statement.
+                std::vector<std::string> _boundText; ///< Text parameters owned by the statement, indexed by parameter index.
+                std::vector< std::vector<uint8_t> > _boundBlobs; ///< BLOB parameters owned by the statement, indexed by parameter index.
+                bool _batchEnd; ///< Flag that is set when FetchBatch() reached the end of the result. Cleared by Reset().
+                std::shared_ptr<statement_status> _finalizedStatus; ///< Total of the connection that receives the counters on destruction.
 
             public:
                 /**
@@ -30,7 +39,8 @@ namespace sqlitelib
                 prepared_statement(sqlite& dbObject, const std::string& sql);
 
                 /**
-                 * @brief Destructor.
+                 * @brief Destructor. Adds the counters of the statement to the total of the connection, which is
+                 * reported by \c sqlite::StatementStatus().
                  */
                 ~prepared_statement();
 
@@ -48,6 +58,15 @@ namespace sqlitelib
                  */
                 void Bind(int paramIndex, const std::vector<uint8_t>& blob);
 
+                /**
+                 * @brief Bind a BLOB to the prepared statement without copying it.
+                 * @details The vector is moved into the statement and kept until the parameter is bound again, the
+                 * bindings are cleared, or the statement is destroyed.
+                 * @param paramIndex Index of the parameter. The left-most parameter has index 1.
+                 * @param blob Vector object that holds the BLOB data.
+                 */
+                void Bind(int paramIndex, std::vector<uint8_t>&& blob);
+
                 /**
                  * @brief Bind a text value to the prepared statement.
                  * @param paramIndex Index of the parameter. The left-most parameter has index 1.
@@ -55,6 +74,15 @@ namespace sqlitelib
                  */
                 void Bind(int paramIndex, const std::string& value);
 
+                /**
+                 * @brief Bind a text value to the prepared statement without copying it.
+                 * @details The string is moved into the statement and kept until the parameter is bound again, the
+                 * bindings are cleared, or the statement is destroyed.
+                 * @param paramIndex Index of the parameter. The left-most parameter has index 1.
+                 * @param value Parameter value.
+                 */
+                void Bind(int paramIndex, std::string&& value);
+
                 /**
                  * @brief Bind a UTF-16 text value to the prepared statement.
                  * @param paramIndex Index of the parameter. The left-most parameter has index 1.
@@ -91,7 +119,25 @@ namespace sqlitelib
                 void BindZeroBlob(int paramIndex, size_t count);
 
                 /**
-                 * @brief Clear all previous bindings.
+                 * @brief Bind a text value to the prepared statement without copying it.
+                 * @details The caller guarantees that the data remains valid and unchanged until the parameter is bound
+                 * again, the bindings are cleared, or the statement is destroyed.
+                 * @param paramIndex Index of the parameter. The left-most parameter has index 1.
+                 * @param value View on the UTF-8 text.
+                 */
+                void BindStatic(int paramIndex, text_view value);
+
+                /**
+                 * @brief Bind a BLOB to the prepared statement without copying it.
+                 * @details The caller guarantees that the data remains valid and unchanged until the parameter is bound
+                 * again, the bindings are cleared, or the statement is destroyed.
+                 * @param paramIndex Index of the parameter. The left-most parameter has index 1.
+                 * @param blob View on the BLOB data.
+                 */
+                void BindStatic(int paramIndex, blob_span blob);
+
+                /**
+                 * @brief Clear all previous bindings and release parameter values owned by the statement.
                  */
                 void ClearBindings();
 
@@ -111,6 +157,13 @@ namespace sqlitelib
                  * @returns The number of columns in the result set.
                  */
                 int ColumnsCount();
+
+                /**
+                 * @brief Returns the number of columns the statement produces. Unlike ColumnsCount() this is available
+                 * before the first row is retrieved.
+                 * @returns The number of columns in the result set, or 0 for a statement that returns no data.
+                 */
+                int ResultColumnsCount();
  
                 /**
                  * @brief Get the index of a named parameter.
@@ -147,6 +200,28 @@ namespace sqlitelib
                 */
                 void Step(StepStatementProcessing& processor);
 
+                /**
+                 * @brief Get the rows of the statement for use in a range-based \c for loop, as an alternative to
+                 * Step() that needs no StepStatementProcessing-derived class.
+                 * @returns Returns a range that steps the statement lazily.
+                 */
+                inline row_range Rows();
+
+                /**
+                 * @brief Retrieve up to \p batch.Capacity() rows into per-column arrays.
+                 * @details Call this repeatedly until \p batch.EndOfResult() returns \c true. Each call replaces the
+                 * contents of the batch. Once the end of the result is reached, further calls return no rows until
+                 * Reset() is called, so the query is not run again by accident.
+                 * @param batch Batch with one column per result column.
+                 * @returns Returns the number of rows stored in the batch.
+                 */
+                size_t FetchBatch(column_batch& batch);
+
+                /**
+                 * @brief Run the statement to completion and discard any rows it returns.
+                 */
+                void Execute();
+
                 /**
                  * @brief Get the value of an integer field
                  * @param index Field index.
@@ -182,6 +257,29 @@ namespace sqlitelib
                  */
                 std::vector<uint8_t> GetBlob(int index);
 
+                /**
+                 * @brief Get the value of a UTF-8 text field without copying it.
+                 * @param index Field index.
+                 * @returns Returns a view on SQLite's buffer that is valid until the next Step() or Reset().
+                 */
+                text_view GetStringView(int index);
+
+                /**
+                 * @brief Get the value of a UTF-16 text field without copying it.
+                 * @details The view holds \c char16_t code units, because \c wchar_t is not 16 bits wide on every
+                 * platform.
+                 * @param index Field index.
+                 * @returns Returns a view on SQLite's buffer that is valid until the next Step() or Reset().
+                 */
+                u16text_view GetWStringView(int index);
+
+                /**
+                 * @brief Get the data in a BLOB field without copying it.
+                 * @param index Field index.
+                 * @returns Returns a view on SQLite's buffer that is valid until the next Step() or Reset().
+                 */
+                blob_span GetBlobSpan(int index);
+
                 /**
                  * @brief Get the value of a \c double field.
                  * @param index Field index.
@@ -201,7 +299,28 @@ namespace sqlitelib
                  * @returns Returns the expanded SQL query.
                  */
                 std::string ExpandedSql();
+
+                /**
+                 * @brief Get the performance counters of the statement.
+                 * @param reset Flag that is set to reset the counters after they are read.
+                 * @returns Returns the counters.
+                 */
+                statement_status Status(bool reset = false);
+
+            private:
+                /**
+                 * @brief Get the slot that keeps an owned parameter value alive while it is bound.
+                 * @param slots Text or BLOB slots of the statement.
+                 * @param paramIndex Index of the parameter. The left-most parameter has index 1.
+                 * @returns Returns a reference to the slot of the parameter.
+                 */
+                template <typename T> T& OwnedParameterSlot(std::vector<T>& slots, int paramIndex);
         }; // class prepared_statement
+
+        inline row_range prepared_statement::Rows()
+        {
+            return row_range(this->_statementPtr);
+        }
     } // namespace SQLite3
 } // namespace sqlitelib
 
@@ -0,0 +1,67 @@
+#include "row_arena.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        row_arena::row_arena(size_t blockSize)
+            :   _blocks(),
+                _currentBlock(0u),
+                _offset(0u),
+                _blockSize(blockSize),
+                _bytesUsed(0u),
+                _blockAllocations(0u)
+        {
+        }
+
+        void* row_arena::Allocate(size_t size, size_t alignment)
+        {
+            while (this->_currentBlock < this->_blocks.size())
+            {
+                block& current = this->_blocks[this->_currentBlock];
+                size_t start = (this->_offset + alignment - 1u) & ~(alignment - 1u);
+                if (start + size <= current.size)
+                {
+                    this->_bytesUsed += (start + size) - this->_offset;
+                    this->_offset = start + size;
+                    return current.data.get() + start;
+                }
+
+                // Move on to the next block that was kept by Reset().
+                ++this->_currentBlock;
+                this->_offset = 0u;
+            }
+
+            // Memory from operator new[] is aligned for any fundamental type, so a new block needs no padding.
+            block added;
+            added.size = (size > this->_blockSize) ? size : this->_blockSize;
+            added.data.reset(new char[added.size]);
+            ++this->_blockAllocations;
+
+            this->_blocks.push_back(std::move(added));
+            this->_currentBlock = this->_blocks.size() - 1u;
+            this->_offset = size;
+            this->_bytesUsed += size;
+
+            return this->_blocks.back().data.get();
+        }
+
+        void row_arena::Reset()
+        {
+            this->_currentBlock = 0u;
+            this->_offset = 0u;
+            this->_bytesUsed = 0u;
+        }
+
+        size_t row_arena::BytesReserved() const
+        {
+            size_t result = 0u;
+            for (const block& current : this->_blocks)
+            {
+                result += current.size;
+            }
+
+            return result;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
@@ -0,0 +1,172 @@
+#if !defined ROW_ARENA_BB0AB32CCFEF460D816674433F5C255D
+#define ROW_ARENA_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "column_view.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Bump allocator for the rows of a result set. Memory is released in one shot by Reset(), which keeps the
+         * blocks for reuse, so a result set that fits into the blocks of a previous one causes no heap allocations.
+         */
+        class row_arena
+        {
+            private:
+                /**
+                 * @brief A block of memory owned by the arena.
+                 */
+                struct block
+                {
+                    std::unique_ptr<char[]> data;   ///< Memory of the block.
+                    size_t size;                    ///< Size of the block in bytes.
+                };
+
+            private:
+                std::vector<block> _blocks;     ///< All blocks of the arena.
+                size_t _currentBlock;           ///< Index of the block that serves allocations.
+                size_t _offset;                 ///< Number of bytes used in the current block.
+                size_t _blockSize;              ///< Size of a regular block.
+                size_t _bytesUsed;              ///< Number of bytes handed out since the last Reset().
+                uint64_t _blockAllocations;     ///< Number of blocks allocated from the heap.
+
+            public:
+                /**
+                 * @brief Construct an empty arena.
+                 * @param blockSize Size of a regular block. Larger requests get a block of their own.
+                 */
+                explicit row_arena(size_t blockSize = 65536u);
+
+            public:
+                /**
+                 * @brief Allocate memory.
+                 * @param size Number of bytes.
+                 * @param alignment Alignment of the memory, a power of two.
+                 * @returns Returns a pointer that stays valid until Reset() is called.
+                 */
+                void* Allocate(size_t size, size_t alignment);
+
+                /**
+                 * @brief Release all allocations. The blocks are kept for reuse.
+                 */
+                void Reset();
+
+                /**
+                 * @brief Returns the number of blocks allocated from the heap since the arena was created.
+                 */
+                inline uint64_t BlockAllocations() const;
+
+                /**
+                 * @brief Returns the number of bytes handed out since the last Reset(), including alignment padding.
+                 */
+                inline size_t BytesUsed() const;
+
+                /**
+                 * @brief Returns the total size of all blocks.
+                 */
+                size_t BytesReserved() const;
+        }; // class row_arena
+
+        /**
+         * @brief A field of a row that is stored in a row_arena.
+         */
+        struct arena_field
+        {
+            text_view name;     ///< Name of the column.
+            text_view value;    ///< Value of the field as text. \c value.data() is \c nullptr for a \c NULL value.
+
+            /**
+             * @brief Check if the value is \c NULL.
+             */
+            inline bool IsNull() const;
+        }; // struct arena_field
+
+        /**
+         * @brief A row that is stored in a row_arena.
+         */
+        class arena_row
+        {
+            private:
+                const arena_field* _fields; ///< First field of the row.
+                size_t _fieldCount;         ///< Number of fields in the row.
+
+            public:
+                /**
+                 * @brief Construct a row.
+                 * @param fields First field of the row.
+                 * @param fieldCount Number of fields in the row.
+                 */
+                inline arena_row(const arena_field* fields, size_t fieldCount);
+
+            public:
+                /**
+                 * @brief Returns the number of fields in the row.
+                 */
+                inline size_t size() const;
+
+                /**
+                 * @brief Access a field.
+                 * @param index Zero-based index of the field.
+                 */
+                inline const arena_field& operator[](size_t index) const;
+
+                /**
+                 * @brief Get an iterator to the first field.
+                 */
+                inline const arena_field* begin() const;
+
+                /**
+                 * @brief Get an iterator past the last field.
+                 */
+                inline const arena_field* end() const;
+        }; // class arena_row
+
+        inline uint64_t row_arena::BlockAllocations() const
+        {
+            return this->_blockAllocations;
+        }
+
+        inline size_t row_arena::BytesUsed() const
+        {
+            return this->_bytesUsed;
+        }
+
+        inline bool arena_field::IsNull() const
+        {
+            return nullptr == this->value.data();
+        }
+
+        inline arena_row::arena_row(const arena_field* fields, size_t fieldCount)
+            :   _fields(fields),
+                _fieldCount(fieldCount)
+        {
+        }
+
+        inline size_t arena_row::size() const
+        {
+            return this->_fieldCount;
+        }
+
+        inline const arena_field& arena_row::operator[](size_t index) const
+        {
+            return this->_fields[index];
+        }
+
+        inline const arena_field* arena_row::begin() const
+        {
+            return this->_fields;
+        }
+
+        inline const arena_field* arena_row::end() const
+        {
+            return this->_fields + this->_fieldCount;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // ROW_ARENA_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,318 @@
+#if !defined ROW_ITERATOR_BB0AB32CCFEF460D816674433F5C255D
+#define ROW_ITERATOR_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include "column_view.hpp"
+#include "DataTypes.hpp"
+#include "sqlite_exception.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief The current row of a statement that is iterated with prepared_statement::Rows().
+         * @details The accessors call the \c sqlite3_column_* functions directly and are inlined into the loop. Values
+         * are only valid until the iterator is advanced.
+         */
+        class result_row
+        {
+            private:
+                sqlite3_stmt* _statementPtr; ///< Handle of the prepared statement.
+
+            public:
+                /**
+                 * @brief Construct a row for a statement.
+                 * @param statementPtr Handle of the prepared statement.
+                 */
+                inline explicit result_row(sqlite3_stmt* statementPtr);
+
+            public:
+                /**
+                 * @brief Returns the number of columns in the row.
+                 */
+                inline int ColumnsCount() const;
+
+                /**
+                 * @brief Get the data type of a field.
+                 * @param index Field index.
+                 */
+                inline sqlite_data_type GetColumnType(int index) const;
+
+                /**
+                 * @brief Check if a field is \c NULL.
+                 * @param index Field index.
+                 */
+                inline bool IsNull(int index) const;
+
+                /**
+                 * @brief Get the value of an integer field.
+                 * @param index Field index.
+                 */
+                inline int GetInt(int index) const;
+
+                /**
+                 * @brief Get the value of a 64-bit integer field.
+                 * @param index Field index.
+                 */
+                inline int64_t GetInt64(int index) const;
+
+                /**
+                 * @brief Get the value of a \c double field.
+                 * @param index Field index.
+                 */
+                inline double GetDouble(int index) const;
+
+                /**
+                 * @brief Get the value of a UTF-8 text field without copying it.
+                 * @param index Field index.
+                 */
+                inline text_view GetStringView(int index) const;
+
+                /**
+                 * @brief Get the data in a BLOB field without copying it.
+                 * @param index Field index.
+                 */
+                inline blob_span GetBlobSpan(int index) const;
+
+                /**
+                 * @brief Get a copy of the value of a UTF-8 text field.
+                 * @param index Field index.
+                 */
+                inline std::string GetString(int index) const;
+
+                /**
+                 * @brief Get a copy of the data in a BLOB field.
+                 * @param index Field index.
+                 */
+                inline std::vector<uint8_t> GetBlob(int index) const;
+        }; // class result_row
+
+        /**
+         * @brief Input iterator that steps a prepared statement.
+         */
+        class row_iterator
+        {
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = result_row;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const result_row*;
+                using reference = const result_row&;
+
+            private:
+                sqlite3_stmt* _statementPtr;    ///< Handle of the prepared statement, or \c nullptr at the end.
+                result_row _row;                ///< The current row.
+
+            public:
+                /**
+                 * @brief Construct an end iterator.
+                 */
+                inline row_iterator();
+
+                /**
+                 * @brief Construct an iterator and step to the first row.
+                 * @param statementPtr Handle of the prepared statement.
+                 */
+                inline explicit row_iterator(sqlite3_stmt* statementPtr);
+
+            public:
+                /**
+                 * @brief Access the current row.
+                 */
+                inline const result_row& operator*() const;
+
+                /**
+                 * @brief Access the current row.
+                 */
+                inline const result_row* operator->() const;
+
+                /**
+                 * @brief Step to the next row.
+                 */
+                inline row_iterator& operator++();
+
+                /**
+                 * @brief Compare two iterators. Iterators are equal if both are at the end.
+                 */
+                inline bool operator==(const row_iterator& other) const;
+
+                /**
+                 * @brief Compare two iterators. Iterators are equal if both are at the end.
+                 */
+                inline bool operator!=(const row_iterator& other) const;
+
+            private:
+                /**
+                 * @brief Call sqlite3_step() and move to the end when no row is returned.
+                 */
+                inline void Step();
+        }; // class row_iterator
+
+        /**
+         * @brief Range of the rows returned by a prepared statement, for use in a range-based \c for loop.
+         * @details The statement is stepped from its current position. Reset the statement to run it again after
+         * leaving the loop early.
+         */
+        class row_range
+        {
+            private:
+                sqlite3_stmt* _statementPtr; ///< Handle of the prepared statement.
+
+            public:
+                /**
+                 * @brief Construct a range for a statement.
+                 * @param statementPtr Handle of the prepared statement.
+                 */
+                inline explicit row_range(sqlite3_stmt* statementPtr);
+
+            public:
+                /**
+                 * @brief Step to the first row.
+                 * @returns Returns an iterator on the first row.
+                 */
+                inline row_iterator begin() const;
+
+                /**
+                 * @brief Get the end iterator.
+                 */
+                inline row_iterator end() const;
+        }; // class row_range
+
+        inline result_row::result_row(sqlite3_stmt* statementPtr)
+            :   _statementPtr(statementPtr)
+        {
+        }
+
+        inline int result_row::ColumnsCount() const
+        {
+            return sqlite3_data_count(this->_statementPtr);
+        }
+
+        inline sqlite_data_type result_row::GetColumnType(int index) const
+        {
+            // The enumerators of sqlite_data_type have the values of the SQLite type codes.
+            return (sqlite_data_type)sqlite3_column_type(this->_statementPtr, index);
+        }
+
+        inline bool result_row::IsNull(int index) const
+        {
+            return sqlite3_column_type(this->_statementPtr, index) == SQLITE_NULL;
+        }
+
+        inline int result_row::GetInt(int index) const
+        {
+            return sqlite3_column_int(this->_statementPtr, index);
+        }
+
+        inline int64_t result_row::GetInt64(int index) const
+        {
+            return (int64_t)sqlite3_column_int64(this->_statementPtr, index);
+        }
+
+        inline double result_row::GetDouble(int index) const
+        {
+            return sqlite3_column_double(this->_statementPtr, index);
+        }
+
+        inline text_view result_row::GetStringView(int index) const
+        {
+            const char* textPtr = (const char*)sqlite3_column_text(this->_statementPtr, index);
+            return text_view(textPtr, (size_t)sqlite3_column_bytes(this->_statementPtr, index));
+        }
+
+        inline blob_span result_row::GetBlobSpan(int index) const
+        {
+            const uint8_t* blobPtr = (const uint8_t*)sqlite3_column_blob(this->_statementPtr, index);
+            return blob_span(blobPtr, (size_t)sqlite3_column_bytes(this->_statementPtr, index));
+        }
+
+        inline std::string result_row::GetString(int index) const
+        {
+            return this->GetStringView(index).ToString();
+        }
+
+        inline std::vector<uint8_t> result_row::GetBlob(int index) const
+        {
+            return this->GetBlobSpan(index).ToVector();
+        }
+
+        inline row_iterator::row_iterator()
+            :   _statementPtr(nullptr),
+                _row(nullptr)
+        {
+        }
+
+        inline row_iterator::row_iterator(sqlite3_stmt* statementPtr)
+            :   _statementPtr(statementPtr),
+                _row(statementPtr)
+        {
+            this->Step();
+        }
+
+        inline const result_row& row_iterator::operator*() const
+        {
+            return this->_row;
+        }
+
+        inline const result_row* row_iterator::operator->() const
+        {
+            return &this->_row;
+        }
+
+        inline row_iterator& row_iterator::operator++()
+        {
+            this->Step();
+            return *this;
+        }
+
+        inline bool row_iterator::operator==(const row_iterator& other) const
+        {
+            return this->_statementPtr == other._statementPtr;
+        }
+
+        inline bool row_iterator::operator!=(const row_iterator& other) const
+        {
+            return this->_statementPtr != other._statementPtr;
+        }
+
+        inline void row_iterator::Step()
+        {
+            int returnCode = sqlite3_step(this->_statementPtr);
+            if (returnCode == SQLITE_ROW)
+            {
+                return;
+            }
+
+            sqlite3_stmt* statementPtr = this->_statementPtr;
+            this->_statementPtr = nullptr;
+
+            if (returnCode != SQLITE_DONE)
+            {
+                throw sqlite_exception(returnCode, sqlite3_errmsg(sqlite3_db_handle(statementPtr)));
+            }
+        }
+
+        inline row_range::row_range(sqlite3_stmt* statementPtr)
+            :   _statementPtr(statementPtr)
+        {
+        }
+
+        inline row_iterator row_range::begin() const
+        {
+            return row_iterator(this->_statementPtr);
+        }
+
+        inline row_iterator row_range::end() const
+        {
+            return row_iterator();
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // ROW_ITERATOR_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,65 @@
+#include "serialized_database.hpp"
+
+#if SQLITE_VERSION_NUMBER >= 3023000
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        serialized_database::serialized_database(uint8_t* data, size_t size, bool owned)
+            :   _data(data),
+                _size(size),
+                _owned(owned)
+        {
+        }
+
+        serialized_database::serialized_database(serialized_database&& src)
+            :   _data(src._data),
+                _size(src._size),
+                _owned(src._owned)
+        {
+            src._data = nullptr;
+            src._size = 0u;
+            src._owned = false;
+        }
+
+        serialized_database::~serialized_database()
+        {
+            if (this->_owned)
+            {
+                sqlite3_free(this->_data);
+            }
+        }
+
+        serialized_database& serialized_database::operator=(serialized_database&& src)
+        {
+            if (this != &src)
+            {
+                if (this->_owned)
+                {
+                    sqlite3_free(this->_data);
+                }
+
+                this->_data = src._data;
+                this->_size = src._size;
+                this->_owned = src._owned;
+                src._data = nullptr;
+                src._size = 0u;
+                src._owned = false;
+            }
+
+            return *this;
+        }
+
+        uint8_t* serialized_database::Release()
+        {
+            uint8_t* result = this->_data;
+            this->_data = nullptr;
+            this->_size = 0u;
+            this->_owned = false;
+            return result;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // SQLITE_VERSION_NUMBER
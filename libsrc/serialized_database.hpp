@@ -0,0 +1,111 @@
+#if !defined SERIALIZED_DATABASE_BB0AB32CCFEF460D816674433F5C255D
+#define SERIALIZED_DATABASE_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstddef>
+#include <cstdint>
+#include <sqlite3.h>
+
+// sqlite3_serialize() and sqlite3_deserialize() were added in SQLite 3.23.0.
+#if SQLITE_VERSION_NUMBER >= 3023000
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Image of a database, as returned by sqlite::Serialize().
+         * @details The image either owns a copy of the database, which is freed with \c sqlite3_free(), or refers to
+         * the memory of an in-memory database without copying it. A reference is only valid until the database is
+         * changed or closed.
+         */
+        class serialized_database
+        {
+            private:
+                uint8_t* _data; ///< The image.
+                size_t _size;   ///< Size of the image in bytes.
+                bool _owned;    ///< Flag that is set if \c _data is freed by this object.
+
+            public:
+                /**
+                 * @brief Construct an image.
+                 * @param data The image.
+                 * @param size Size of the image in bytes.
+                 * @param owned Flag that is set if \p data was allocated by SQLite and is freed by this object.
+                 */
+                serialized_database(uint8_t* data, size_t size, bool owned);
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                serialized_database(const serialized_database& src) = delete;
+
+                /**
+                 * @brief Move constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                serialized_database(serialized_database&& src);
+
+                /**
+                 * @brief Destructor. Frees an owned image.
+                 */
+                ~serialized_database();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                serialized_database& operator=(const serialized_database& src) = delete;
+
+                /**
+                 * @brief Move assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                serialized_database& operator=(serialized_database&& src);
+
+            public:
+                /**
+                 * @brief Returns a pointer to the image.
+                 */
+                inline const uint8_t* Data() const;
+
+                /**
+                 * @brief Returns the size of the image in bytes.
+                 */
+                inline size_t Size() const;
+
+                /**
+                 * @brief Check if the image is a copy owned by this object.
+                 * @retval true The image is a copy.
+                 * @retval false The image refers to the memory of an in-memory database.
+                 */
+                inline bool Owned() const;
+
+                /**
+                 * @brief Give up ownership of the image.
+                 * @returns Returns the image, which must be freed with \c sqlite3_free() if Owned() returned \c true.
+                 */
+                uint8_t* Release();
+        }; // class serialized_database
+
+        inline const uint8_t* serialized_database::Data() const
+        {
+            return this->_data;
+        }
+
+        inline size_t serialized_database::Size() const
+        {
+            return this->_size;
+        }
+
+        inline bool serialized_database::Owned() const
+        {
+            return this->_owned;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // SQLITE_VERSION_NUMBER
+
+#endif // SERIALIZED_DATABASE_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,424 @@
+#if !defined SQL_FUNCTION_BB0AB32CCFEF460D816674433F5C255D
+#define SQL_FUNCTION_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "column_view.hpp"
+#include "sqlite_exception.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Properties of an SQL function that is registered with sqlite::CreateFunction(). Flags that the SQLite
+         * version does not know are ignored.
+         */
+        enum class function_flags : int
+        {
+            none = 0,                               ///< No properties.
+            deterministic = SQLITE_DETERMINISTIC,   ///< The function returns the same result for the same arguments, so SQLite can factor it out of loops and use it in indexes.
+            #if SQLITE_VERSION_NUMBER >= 3030000
+            direct_only = SQLITE_DIRECTONLY,        ///< The function may only be called from top-level SQL, not from triggers, views or schema definitions.
+            #else
+            direct_only = 0,                        ///< The function may only be called from top-level SQL, not from triggers, views or schema definitions.
+            #endif // SQLITE_VERSION_NUMBER
+            #if SQLITE_VERSION_NUMBER >= 3031000
+            innocuous = SQLITE_INNOCUOUS            ///< The function has no side effects and may be used in schema definitions even if the schema is not trusted.
+            #else
+            innocuous = 0                           ///< The function has no side effects and may be used in schema definitions even if the schema is not trusted.
+            #endif // SQLITE_VERSION_NUMBER
+        }; // enum class function_flags
+
+        /**
+         * @brief Combine function flags.
+         */
+        inline function_flags operator|(function_flags left, function_flags right)
+        {
+            return (function_flags)((int)left | (int)right);
+        }
+
+        /**
+         * @brief Reads an argument of an SQL function as type \p T. Specializations exist for \c int, \c int64_t,
+         * \c double, \c bool, \c std::string, \c std::vector<uint8_t>, \c text_view, \c blob_span and \c sqlite3_value*.
+         */
+        template <typename T> struct function_argument;
+
+        template <> struct function_argument<int>
+        {
+            static inline int Read(sqlite3_value* value) { return sqlite3_value_int(value); }
+        };
+
+        template <> struct function_argument<int64_t>
+        {
+            static inline int64_t Read(sqlite3_value* value) { return (int64_t)sqlite3_value_int64(value); }
+        };
+
+        template <> struct function_argument<double>
+        {
+            static inline double Read(sqlite3_value* value) { return sqlite3_value_double(value); }
+        };
+
+        template <> struct function_argument<bool>
+        {
+            static inline bool Read(sqlite3_value* value) { return sqlite3_value_int(value) != 0; }
+        };
+
+        template <> struct function_argument<text_view>
+        {
+            static inline text_view Read(sqlite3_value* value)
+            {
+                // The pointer must be fetched before the size, see sqlite3_value_bytes().
+                const char* data = (const char*)sqlite3_value_text(value);
+                return text_view(data, (size_t)sqlite3_value_bytes(value));
+            }
+        };
+
+        template <> struct function_argument<blob_span>
+        {
+            static inline blob_span Read(sqlite3_value* value)
+            {
+                const uint8_t* data = (const uint8_t*)sqlite3_value_blob(value);
+                return blob_span(data, (size_t)sqlite3_value_bytes(value));
+            }
+        };
+
+        template <> struct function_argument<std::string>
+        {
+            static inline std::string Read(sqlite3_value* value) { return function_argument<text_view>::Read(value).ToString(); }
+        };
+
+        template <> struct function_argument< std::vector<uint8_t> >
+        {
+            static inline std::vector<uint8_t> Read(sqlite3_value* value) { return function_argument<blob_span>::Read(value).ToVector(); }
+        };
+
+        template <> struct function_argument<sqlite3_value*>
+        {
+            static inline sqlite3_value* Read(sqlite3_value* value) { return value; }
+        };
+
+        /**
+         * @brief Sets the result of an SQL function from a value of type \p T. Specializations exist for \c int,
+         * \c int64_t, \c double, \c bool, \c std::string, \c std::vector<uint8_t>, \c text_view, \c blob_span and
+         * \c std::nullptr_t.
+         */
+        template <typename T> struct function_result;
+
+        template <> struct function_result<int>
+        {
+            static inline void Write(sqlite3_context* context, int value) { sqlite3_result_int(context, value); }
+        };
+
+        template <> struct function_result<int64_t>
+        {
+            static inline void Write(sqlite3_context* context, int64_t value) { sqlite3_result_int64(context, (sqlite3_int64)value); }
+        };
+
+        template <> struct function_result<double>
+        {
+            static inline void Write(sqlite3_context* context, double value) { sqlite3_result_double(context, value); }
+        };
+
+        template <> struct function_result<bool>
+        {
+            static inline void Write(sqlite3_context* context, bool value) { sqlite3_result_int(context, value ? 1 : 0); }
+        };
+
+        template <> struct function_result<text_view>
+        {
+            static inline void Write(sqlite3_context* context, const text_view& value) { sqlite3_result_text64(context, value.data(), (sqlite3_uint64)value.size(), SQLITE_TRANSIENT, SQLITE_UTF8); }
+        };
+
+        template <> struct function_result<blob_span>
+        {
+            static inline void Write(sqlite3_context* context, const blob_span& value) { sqlite3_result_blob64(context, value.data(), (sqlite3_uint64)value.size(), SQLITE_TRANSIENT); }
+        };
+
+        template <> struct function_result<std::string>
+        {
+            static inline void Write(sqlite3_context* context, const std::string& value) { sqlite3_result_text64(context, value.data(), (sqlite3_uint64)value.size(), SQLITE_TRANSIENT, SQLITE_UTF8); }
+        };
+
+        template <> struct function_result< std::vector<uint8_t> >
+        {
+            static inline void Write(sqlite3_context* context, const std::vector<uint8_t>& value) { sqlite3_result_blob64(context, value.data(), (sqlite3_uint64)value.size(), SQLITE_TRANSIENT); }
+        };
+
+        template <> struct function_result<std::nullptr_t>
+        {
+            static inline void Write(sqlite3_context* context, std::nullptr_t) { sqlite3_result_null(context); }
+        };
+
+        /**
+         * @brief Result and argument types of a callable object, deduced from its signature.
+         */
+        template <typename Function> struct function_traits : function_traits<decltype(&Function::operator())>
+        {
+        };
+
+        template <typename Result, typename... Arguments> struct function_traits<Result(Arguments...)>
+        {
+            using result_type = typename std::decay<Result>::type;                          ///< Result type without reference and cv-qualifiers.
+            using argument_types = std::tuple<typename std::decay<Arguments>::type...>;     ///< Argument types without reference and cv-qualifiers.
+            static const int arity = (int)sizeof...(Arguments);                             ///< Number of arguments.
+        };
+
+        template <typename Result, typename... Arguments> struct function_traits<Result(*)(Arguments...)> : function_traits<Result(Arguments...)>
+        {
+        };
+
+        template <typename Class, typename Result, typename... Arguments> struct function_traits<Result(Class::*)(Arguments...)> : function_traits<Result(Arguments...)>
+        {
+        };
+
+        template <typename Class, typename Result, typename... Arguments> struct function_traits<Result(Class::*)(Arguments...) const> : function_traits<Result(Arguments...)>
+        {
+        };
+
+        /**
+         * @brief Report the exception that is being handled as the error of an SQL function.
+         * @param context Context of the function call.
+         */
+        inline void ReportFunctionError(sqlite3_context* context)
+        {
+            try
+            {
+                throw;
+            }
+            catch (const sqlite_exception& ex)
+            {
+                sqlite3_result_error(context, ex.what(), -1);
+                sqlite3_result_error_code(context, ex.GetReturnCode());
+            }
+            catch (const std::bad_alloc&)
+            {
+                sqlite3_result_error_nomem(context);
+            }
+            catch (const std::exception& ex)
+            {
+                sqlite3_result_error(context, ex.what(), -1);
+            }
+            catch (...)
+            {
+                sqlite3_result_error(context, "Unknown exception in an SQL function", -1);
+            }
+        }
+
+        /**
+         * @brief Adapter between SQLite and a callable object that implements a scalar SQL function.
+         * @details The conversion of each argument and of the result is selected at compile time from the signature of
+         * \p Function, so a call does no type dispatch at run time.
+         */
+        template <typename Function> struct scalar_function
+        {
+            using traits = function_traits<Function>;
+
+            /**
+             * @brief Called by SQLite to run the function.
+             * @param context Context of the function call. Its user data is the callable object.
+             * @param argumentCount Number of arguments, which SQLite has checked against the arity.
+             * @param arguments The arguments.
+             */
+            static void Invoke(sqlite3_context* context, int /*argumentCount*/, sqlite3_value** arguments)
+            {
+                try
+                {
+                    Call(*(Function*)sqlite3_user_data(context), context, arguments, std::make_index_sequence<traits::arity>(), std::is_void<typename traits::result_type>());
+                }
+                catch (...)
+                {
+                    ReportFunctionError(context);
+                }
+            }
+
+            /**
+             * @brief Called by SQLite to destroy the callable object when the function is removed.
+             * @param function The callable object.
+             */
+            static void Destroy(void* function)
+            {
+                delete (Function*)function;
+            }
+
+            template <size_t... Indexes> static void Call(Function& function, sqlite3_context* context, sqlite3_value** arguments, std::index_sequence<Indexes...>, std::false_type)
+            {
+                function_result<typename traits::result_type>::Write(context, function(function_argument<typename std::tuple_element<Indexes, typename traits::argument_types>::type>::Read(arguments[Indexes])...));
+            }
+
+            template <size_t... Indexes> static void Call(Function& function, sqlite3_context* context, sqlite3_value** arguments, std::index_sequence<Indexes...>, std::true_type)
+            {
+                function(function_argument<typename std::tuple_element<Indexes, typename traits::argument_types>::type>::Read(arguments[Indexes])...);
+                sqlite3_result_null(context);
+            }
+        }; // struct scalar_function
+
+        /**
+         * @brief Adapter between SQLite and a class that implements an aggregate or window SQL function.
+         * @details One instance of \p Aggregate is constructed per group, in place in the memory that
+         * \c sqlite3_aggregate_context() provides, so no heap allocation is made beyond the one SQLite makes for the
+         * group. The class must be default constructible and have the members
+         * - \c Step(arguments...), called for each row that is added to the group or window,
+         * - \c Final(), which returns the result and is called once at the end,
+         * - for a window function, \c Inverse(arguments...), called for each row that leaves the window, and
+         *   \c Value(), which returns the current result and may be called more than once.
+         *
+         * The types of the arguments and of the result are deduced as for scalar_function. \c Final() and \c Value()
+         * are called on a default constructed instance if the group has no rows.
+         */
+        template <typename Aggregate> struct aggregate_function
+        {
+            using step_traits = function_traits<decltype(&Aggregate::Step)>;
+
+            /**
+             * @brief Layout of the aggregate context. SQLite fills it with zeros when it is allocated.
+             */
+            struct state
+            {
+                typename std::aligned_storage<sizeof(Aggregate), alignof(Aggregate)>::type storage; ///< The instance.
+                bool constructed;                                                                   ///< Flag that is set once the instance has been constructed.
+            };
+
+            // SQLite aligns the aggregate context to 8 bytes.
+            static_assert(alignof(state) <= 8u, "The aggregate class must not need more than 8 byte alignment");
+
+            /**
+             * @brief Called by SQLite for each row of the group.
+             * @param context Context of the function call.
+             * @param argumentCount Number of arguments, which SQLite has checked against the arity.
+             * @param arguments The arguments.
+             */
+            static void Step(sqlite3_context* context, int /*argumentCount*/, sqlite3_value** arguments)
+            {
+                try
+                {
+                    Call(*Instance(context), &Aggregate::Step, arguments, std::make_index_sequence<step_traits::arity>());
+                }
+                catch (...)
+                {
+                    ReportFunctionError(context);
+                }
+            }
+
+            /**
+             * @brief Called by SQLite for each row that leaves the window.
+             * @param context Context of the function call.
+             * @param argumentCount Number of arguments.
+             * @param arguments The arguments.
+             */
+            static void Inverse(sqlite3_context* context, int /*argumentCount*/, sqlite3_value** arguments)
+            {
+                try
+                {
+                    Call(*Instance(context), &Aggregate::Inverse, arguments, std::make_index_sequence<function_traits<decltype(&Aggregate::Inverse)>::arity>());
+                }
+                catch (...)
+                {
+                    ReportFunctionError(context);
+                }
+            }
+
+            /**
+             * @brief Called by SQLite to get the current result of a window function.
+             * @param context Context of the function call.
+             */
+            static void Value(sqlite3_context* context)
+            {
+                try
+                {
+                    state* statePtr = (state*)sqlite3_aggregate_context(context, 0);
+                    if ((statePtr != nullptr) && statePtr->constructed)
+                    {
+                        Result(context, ((Aggregate*)&statePtr->storage)->Value());
+                    }
+                    else
+                    {
+                        Aggregate empty;
+                        Result(context, empty.Value());
+                    }
+                }
+                catch (...)
+                {
+                    ReportFunctionError(context);
+                }
+            }
+
+            /**
+             * @brief Called by SQLite to get the result at the end of the group. Destroys the instance.
+             * @param context Context of the function call.
+             */
+            static void Final(sqlite3_context* context)
+            {
+                // SQLite also calls this when the statement is aborted after an error in Step().
+                state* statePtr = (state*)sqlite3_aggregate_context(context, 0);
+                if ((statePtr != nullptr) && statePtr->constructed)
+                {
+                    Aggregate* instance = (Aggregate*)&statePtr->storage;
+                    try
+                    {
+                        Result(context, instance->Final());
+                    }
+                    catch (...)
+                    {
+                        ReportFunctionError(context);
+                    }
+
+                    instance->~Aggregate();
+                    statePtr->constructed = false;
+                    return;
+                }
+
+                try
+                {
+                    Aggregate empty;
+                    Result(context, empty.Final());
+                }
+                catch (...)
+                {
+                    ReportFunctionError(context);
+                }
+            }
+
+            /**
+             * @brief Get the instance of the group, constructing it on first use.
+             * @param context Context of the function call.
+             * @returns Returns the instance.
+             */
+            static Aggregate* Instance(sqlite3_context* context)
+            {
+                state* statePtr = (state*)sqlite3_aggregate_context(context, (int)sizeof(state));
+                if (statePtr == nullptr)
+                {
+                    throw std::bad_alloc();
+                }
+
+                if (!statePtr->constructed)
+                {
+                    new (&statePtr->storage) Aggregate();
+                    statePtr->constructed = true;
+                }
+
+                return (Aggregate*)&statePtr->storage;
+            }
+
+            template <typename Method, size_t... Indexes> static void Call(Aggregate& instance, Method method, sqlite3_value** arguments, std::index_sequence<Indexes...>)
+            {
+                (instance.*method)(function_argument<typename std::tuple_element<Indexes, typename function_traits<Method>::argument_types>::type>::Read(arguments[Indexes])...);
+            }
+
+            template <typename T> static void Result(sqlite3_context* context, const T& value)
+            {
+                function_result<T>::Write(context, value);
+            }
+        }; // struct aggregate_function
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // SQL_FUNCTION_BB0AB32CCFEF460D816674433F5C255D
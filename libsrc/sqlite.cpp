@@ -1,7 +1,12 @@
 #include "sqlite.hpp"
+#include "statement_cache.hpp"
+#include "statement_profiler.hpp"
+#include <cctype>
+#include <chrono>
 #include <locale>
 #include <string>
 #include <codecvt>
+#include <cstring>
 
 namespace sqlitelib
 {
@@ -13,7 +18,11 @@ namespace sqlitelib
     namespace SQLite3
     {
         sqlite::sqlite(STRING dbFilePath, int flags)
-            :   _dbObject(nullptr)
+            :   _dbObject(nullptr),
+                _statementCache(new statement_cache(open_options::DefaultStatementCacheCapacity)),
+                _profiler(),
+                _walHook(),
+                _finalizedStatus(std::make_shared<statement_status>())
         {
             // Pointer to the SQLite database object
             sqlite3* dbPtr;
@@ -23,7 +32,7 @@ namespace sqlitelib
 
             #ifdef _WIN32
                 rc = sqlite3_open_v2(sqlite::Utf16ToUtf8String(dbFilePath).c_str(), &dbPtr, flags, nullptr);
-            #elif __gnu_linux
+            #elif defined(__gnu_linux__) || defined(__gnu_linux)
                 rc = sqlite3_open_v2(dbFilePath.c_str(), &dbPtr, flags, nullptr);
             #endif //
 
@@ -38,14 +47,74 @@ namespace sqlitelib
             _dbObject = dbPtr;
         }
 
+        /**
+         * @brief Append a pragma with a keyword value to a list of statements.
+         * @param pragmas The list of statements.
+         * @param name Name of the pragma.
+         * @param value Value of the pragma, which is checked to be a single keyword.
+         */
+        static void AppendPragma(string& pragmas, const char* name, const string& value)
+        {
+            for (char character : value)
+            {
+                if (!std::isalnum((unsigned char)character) && (character != '_'))
+                {
+                    throw sqlite_exception(SQLITE_MISUSE, "Invalid pragma value");
+                }
+            }
+
+            pragmas.append("PRAGMA ").append(name).append(" = ").append(value).append(";");
+        }
+
+        sqlite::sqlite(STRING dbFilePath, const open_options& options)
+            :   sqlite(dbFilePath, options.flags)
+        {
+            string pragmas;
+            if (options.mmapSize >= 0)
+            {
+                pragmas.append("PRAGMA mmap_size = ").append(std::to_string(options.mmapSize)).append(";");
+            }
+
+            if (options.cacheSize != 0)
+            {
+                pragmas.append("PRAGMA cache_size = ").append(std::to_string(options.cacheSize)).append(";");
+            }
+
+            if (!options.tempStore.empty())
+            {
+                AppendPragma(pragmas, "temp_store", options.tempStore);
+            }
+
+            if (!options.lockingMode.empty())
+            {
+                AppendPragma(pragmas, "locking_mode", options.lockingMode);
+            }
+
+            this->_statementCache->Capacity(options.statementCacheCapacity);
+
+            // The delegating constructor has completed, so the destructor closes the connection if this throws.
+            if (!pragmas.empty())
+            {
+                this->Exec(pragmas);
+            }
+        }
+
         sqlite::sqlite(sqlite&& src)
-            :   _dbObject(src._dbObject)
+            :   _dbObject(src._dbObject),
+                _statementCache(std::move(src._statementCache)),
+                _profiler(std::move(src._profiler)),
+                _walHook(std::move(src._walHook)),
+                _finalizedStatus(std::move(src._finalizedStatus))
         {
             src._dbObject = nullptr;
         }
 
         sqlite& sqlite::operator=(sqlite&& src)
         {
+            this->_statementCache = std::move(src._statementCache);
+            this->_profiler = std::move(src._profiler);
+            this->_walHook = std::move(src._walHook);
+            this->_finalizedStatus = std::move(src._finalizedStatus);
             this->_dbObject = src._dbObject;
             src._dbObject = nullptr;
             return *this;
@@ -53,6 +122,10 @@ namespace sqlitelib
 
         sqlite::~sqlite()
         {
+            // Cached statements must be finalized before the connection is closed.
+            this->_statementCache.reset();
+            this->_profiler.reset();
+
             if (this->_dbObject != nullptr)
             {
                 int rc = sqlite3_close_v2(_dbObject);
@@ -76,7 +149,7 @@ namespace sqlitelib
         void sqlite::Exec(const string& sql)
         {
             sqlite_object<char*> error;
-            int rc = sqlite3_exec(this->_dbObject, sql.c_str(), nullptr, nullptr, &((char*)error));
+            int rc = sqlite3_exec(this->_dbObject, sql.c_str(), nullptr, nullptr, &static_cast<char*&>(error));
 
             if (SQLITE_OK != rc)
             {
@@ -87,7 +160,7 @@ namespace sqlitelib
         void sqlite::Exec(const string& sql, exec_result& resultProcessor)
         {
             sqlite_object<char*> error;
-            int rc = sqlite3_exec(this->_dbObject, sql.c_str(), sqlite::ExecCallback, (void*)&resultProcessor, &((char*)error));
+            int rc = sqlite3_exec(this->_dbObject, sql.c_str(), sqlite::ExecCallback, (void*)&resultProcessor, &static_cast<char*&>(error));
 
             if (SQLITE_OK != rc)
             {
@@ -95,9 +168,74 @@ namespace sqlitelib
             }
         }
 
+        void sqlite::Exec(const string& sql, exec_stream& resultProcessor)
+        {
+            const char* sqlPtr = sql.c_str();
+            const char* sqlEnd = sqlPtr + sql.size();
+            vector<text_view> columnNames;
+
+            while (sqlPtr < sqlEnd)
+            {
+                sqlite3_stmt* statementHandle = nullptr;
+                const char* tailPtr = nullptr;
+                int rc = sqlite3_prepare_v2(this->_dbObject, sqlPtr, (int)(sqlEnd - sqlPtr), &statementHandle, &tailPtr);
+                if (rc != SQLITE_OK)
+                {
+                    throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+                }
+
+                std::unique_ptr<sqlite3_stmt, int (*)(sqlite3_stmt*)> statementPtr(statementHandle, sqlite3_finalize);
+                sqlPtr = tailPtr;
+
+                if (nullptr == statementHandle)
+                {
+                    // Whitespace or a comment.
+                    continue;
+                }
+
+                int columnCount = sqlite3_column_count(statementHandle);
+                if (columnCount > 0)
+                {
+                    columnNames.clear();
+                    for (int index = 0; index < columnCount; ++index)
+                    {
+                        const char* namePtr = sqlite3_column_name(statementHandle, index);
+                        columnNames.push_back(text_view(namePtr, string::traits_type::length(namePtr)));
+                    }
+
+                    resultProcessor.ResultStart(columnNames);
+                }
+
+                result_row row(statementHandle);
+                while ((rc = sqlite3_step(statementHandle)) == SQLITE_ROW)
+                {
+                    if (!resultProcessor.RowData(row))
+                    {
+                        resultProcessor.ResultEnd();
+                        return;
+                    }
+                }
+
+                if (rc != SQLITE_DONE)
+                {
+                    throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+                }
+
+                if (columnCount > 0)
+                {
+                    resultProcessor.ResultEnd();
+                }
+            }
+        }
+
         int sqlite::ExecCallback(void* userData, int numFields, char** fieldValues, char** fieldNames)
         {
             exec_result* resultProcessorPtr = (exec_result*)userData;
+            if (resultProcessorPtr->UseArena())
+            {
+                return resultProcessorPtr->StoreRow((size_t)numFields, fieldNames, fieldValues) ? 0 : 1;
+            }
+
             if (resultProcessorPtr->ReturnFieldNames())
             {
                 return resultProcessorPtr->RowData(StringsArrayToVector((size_t)numFields, fieldNames, fieldValues)) ? 0 : 1;
@@ -119,7 +257,7 @@ namespace sqlitelib
 
             for (size_t index = 0u; index < fieldCount; ++index)
             {
-                result.push_back(fieldValues[index]);
+                result.push_back((nullptr == fieldValues[index]) ? string() : string(fieldValues[index]));
             }
 
             return std::move(result);
@@ -132,7 +270,7 @@ namespace sqlitelib
 
             for (size_t index = 0u; index < fieldCount; ++index)
             {
-                result.push_back(pair< string, string >(fieldNames[index], fieldValues[index]));
+                result.push_back(pair< string, string >(fieldNames[index], (nullptr == fieldValues[index]) ? string() : string(fieldValues[index])));
             }
 
             return std::move(result);
@@ -167,5 +305,265 @@ namespace sqlitelib
             return (int64_t)sqlite3_last_insert_rowid(this->_dbObject);
         }
 
+        bool sqlite::AutoCommit()
+        {
+            return sqlite3_get_autocommit(this->_dbObject) == 0 ? false : true;
+        }
+
+        int64_t sqlite::MmapSize(const string& dbName)
+        {
+            // A negative value queries the current limit without changing it.
+            sqlite3_int64 size = -1;
+            int rc = sqlite3_file_control(this->_dbObject, dbName.c_str(), SQLITE_FCNTL_MMAP_SIZE, &size);
+            if (rc == SQLITE_NOTFOUND)
+            {
+                return 0;
+            }
+
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+            }
+
+            return (size < 0) ? 0 : (int64_t)size;
+        }
+
+        cached_statement sqlite::PrepareCached(const string& sql)
+        {
+            return this->_statementCache->Acquire(*this, sql);
+        }
+
+        void sqlite::StatementCacheCapacity(size_t capacity)
+        {
+            this->_statementCache->Capacity(capacity);
+        }
+
+        statement_cache_stats sqlite::StatementCacheStats() const
+        {
+            return this->_statementCache->Stats();
+        }
+
+        void sqlite::ResetStatementCacheStats()
+        {
+            this->_statementCache->ResetStats();
+        }
+
+        void sqlite::ClearStatementCache()
+        {
+            this->_statementCache->Clear();
+        }
+
+        checkpoint_result sqlite::Checkpoint(checkpoint_mode mode, const string& dbName)
+        {
+            checkpoint_result result;
+            result.logFrames = -1;
+            result.checkpointedFrames = -1;
+            result.busy = false;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            int rc = sqlite3_wal_checkpoint_v2(this->_dbObject, dbName.empty() ? nullptr : dbName.c_str(), (int)mode, &result.logFrames, &result.checkpointedFrames);
+            result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (rc == SQLITE_BUSY)
+            {
+                result.busy = true;
+            }
+            else if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+            }
+
+            return result;
+        }
+
+        void sqlite::WalAutoCheckpoint(int frames)
+        {
+            int rc = sqlite3_wal_autocheckpoint(this->_dbObject, frames);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, ROUTINE_NAME);
+            }
+
+            this->_walHook.reset();
+        }
+
+        void sqlite::WalHook(wal_hook hook)
+        {
+            if (!hook)
+            {
+                sqlite3_wal_hook(this->_dbObject, nullptr, nullptr);
+                this->_walHook.reset();
+                return;
+            }
+
+            // The callback lives on the heap, so its address stays valid when the connection object is moved.
+            std::unique_ptr<wal_hook> hookPtr(new wal_hook(std::move(hook)));
+            sqlite3_wal_hook(this->_dbObject, sqlite::WalHookCallback, hookPtr.get());
+            this->_walHook = std::move(hookPtr);
+        }
+
+        int sqlite::WalHookCallback(void* userData, sqlite3* /*dbObject*/, const char* dbName, int frames)
+        {
+            try
+            {
+                (*(wal_hook*)userData)(string(dbName), frames);
+            }
+            catch (...)
+            {
+                // The commit has already succeeded.
+            }
+
+            return SQLITE_OK;
+        }
+
+        void sqlite::RemoveFunction(const string& name, int argumentCount)
+        {
+            int rc = sqlite3_create_function_v2(this->_dbObject, name.c_str(), argumentCount, SQLITE_UTF8, nullptr, nullptr, nullptr, nullptr, nullptr);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+            }
+        }
+
+        void sqlite::RegisterFunction(const string& name, int argumentCount, function_flags flags, void* userData, void (*function)(sqlite3_context*, int, sqlite3_value**), void (*step)(sqlite3_context*, int, sqlite3_value**), void (*final)(sqlite3_context*), void (*destroy)(void*))
+        {
+            // SQLite calls destroy if the registration fails, so userData must not be released here.
+            int rc = sqlite3_create_function_v2(this->_dbObject, name.c_str(), argumentCount, SQLITE_UTF8 | (int)flags, userData, function, step, final, destroy);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+            }
+        }
+
+        #if SQLITE_VERSION_NUMBER >= 3025000
+        void sqlite::RegisterWindowFunction(const string& name, int argumentCount, function_flags flags, void (*step)(sqlite3_context*, int, sqlite3_value**), void (*final)(sqlite3_context*), void (*value)(sqlite3_context*), void (*inverse)(sqlite3_context*, int, sqlite3_value**))
+        {
+            int rc = sqlite3_create_window_function(this->_dbObject, name.c_str(), argumentCount, SQLITE_UTF8 | (int)flags, nullptr, step, final, value, inverse, nullptr);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+            }
+        }
+        #endif // SQLITE_VERSION_NUMBER
+
+        #if SQLITE_VERSION_NUMBER >= 3023000
+        serialized_database sqlite::Serialize(const string& dbName)
+        {
+            sqlite3_int64 size = 0;
+            unsigned char* dataPtr = sqlite3_serialize(this->_dbObject, dbName.c_str(), &size, SQLITE_SERIALIZE_NOCOPY);
+            if (dataPtr != nullptr)
+            {
+                return serialized_database(dataPtr, (size_t)size, false);
+            }
+
+            // The database is not held in contiguous memory, or is empty.
+            dataPtr = sqlite3_serialize(this->_dbObject, dbName.c_str(), &size, 0);
+            if ((nullptr == dataPtr) && (size != 0))
+            {
+                throw sqlite_exception(SQLITE_NOMEM, ROUTINE_NAME);
+            }
+
+            return serialized_database(dataPtr, (size_t)size, true);
+        }
+
+        void sqlite::Deserialize(const void* data, size_t size, const string& dbName)
+        {
+            unsigned char* copyPtr = (unsigned char*)sqlite3_malloc64((sqlite3_uint64)((size == 0u) ? 1u : size));
+            if (nullptr == copyPtr)
+            {
+                throw sqlite_exception(SQLITE_NOMEM, ROUTINE_NAME);
+            }
+
+            if (size != 0u)
+            {
+                std::memcpy(copyPtr, data, size);
+            }
+
+            // SQLite frees the copy, also if the call fails.
+            int rc = sqlite3_deserialize(this->_dbObject, dbName.c_str(), copyPtr, (sqlite3_int64)size, (sqlite3_int64)size, SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+            }
+        }
+
+        void sqlite::Deserialize(serialized_database&& image, const string& dbName)
+        {
+            if (!image.Owned())
+            {
+                this->Deserialize(image.Data(), image.Size(), dbName);
+                image = serialized_database(nullptr, 0u, false);
+                return;
+            }
+
+            // The owned image was allocated by SQLite, so SQLite can take it over and free it.
+            sqlite3_int64 size = (sqlite3_int64)image.Size();
+            int rc = sqlite3_deserialize(this->_dbObject, dbName.c_str(), image.Release(), size, size, SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_RESIZEABLE);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+            }
+        }
+
+        void sqlite::DeserializeReadOnly(const void* data, size_t size, const string& dbName)
+        {
+            // SQLite does not write to a read-only image that it may not resize.
+            int rc = sqlite3_deserialize(this->_dbObject, dbName.c_str(), (unsigned char*)data, (sqlite3_int64)size, (sqlite3_int64)size, SQLITE_DESERIALIZE_READONLY);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, sqlite3_errmsg(this->_dbObject));
+            }
+        }
+        #endif // SQLITE_VERSION_NUMBER
+
+        connection_stats sqlite::Stats(bool reset)
+        {
+            return connection_stats::Read(this->_dbObject, reset);
+        }
+
+        statement_status sqlite::StatementStatus(bool reset)
+        {
+            statement_status result = *this->_finalizedStatus;
+            if (reset)
+            {
+                *this->_finalizedStatus = statement_status();
+            }
+
+            for (sqlite3_stmt* statementPtr = sqlite3_next_stmt(this->_dbObject, nullptr); statementPtr != nullptr; statementPtr = sqlite3_next_stmt(this->_dbObject, statementPtr))
+            {
+                result += statement_status::Read(statementPtr, reset);
+            }
+
+            return result;
+        }
+
+        void sqlite::StatementStatus(vector< pair<string, statement_status> >& statusOut, bool reset)
+        {
+            statusOut.clear();
+            for (sqlite3_stmt* statementPtr = sqlite3_next_stmt(this->_dbObject, nullptr); statementPtr != nullptr; statementPtr = sqlite3_next_stmt(this->_dbObject, statementPtr))
+            {
+                const char* sql = sqlite3_sql(statementPtr);
+                statusOut.push_back(pair<string, statement_status>((nullptr == sql) ? string() : string(sql), statement_status::Read(statementPtr, reset)));
+            }
+        }
+
+        statement_profiler& sqlite::EnableProfiling(uint64_t slowThresholdNanoseconds, size_t slowLogCapacity)
+        {
+            // The previous profiler unregisters its callback, so it is destroyed before the new one registers.
+            this->_profiler.reset();
+            this->_profiler.reset(new statement_profiler(this->_dbObject, slowThresholdNanoseconds, slowLogCapacity));
+            return *this->_profiler;
+        }
+
+        void sqlite::DisableProfiling()
+        {
+            this->_profiler.reset();
+        }
+
+        statement_profiler* sqlite::Profiler()
+        {
+            return this->_profiler.get();
+        }
+
     } // namespace SQLite3
 } // namespace sqlitelib
@@ -1,18 +1,39 @@
 #if !defined SQL_LITE_BB0AB32CCFEF460D816674433F5C255D
 #define SQL_LITE_BB0AB32CCFEF460D816674433F5C255D
 
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 #include <sqlite3.h>
+#include "checkpoint_result.hpp"
+#include "connection_stats.hpp"
 #include "DataTypes.hpp"
 #include "exec_result.hpp"
+#include "exec_stream.hpp"
+#include "open_options.hpp"
+#include "serialized_database.hpp"
+#include "sql_function.hpp"
 #include "sqlite_exception.hpp"
 #include "sqlite_object.hpp"
+#include "statement_status.hpp"
 
 namespace sqlitelib
 {
     namespace SQLite3
     {
         class prepared_statement;
+        class cached_statement;
+        class statement_cache;
+        struct statement_cache_stats;
+        class statement_profiler;
+
+        /**
+         * @brief Callback that is called after a commit in WAL mode, with the name of the database and the number of
+         * frames in its WAL file.
+         */
+        using wal_hook = std::function<void(const std::string& dbName, int frames)>;
 
         /**
          * @brief Wrapper class for the sqlite3_open() and sqlite3_close() sequence
@@ -20,9 +41,16 @@ namespace sqlitelib
         class sqlite
         {
             friend class prepared_statement;
+            friend class backup;
+            friend class blob_stream;
+            friend class container_table_base;
 
             private:
                 sqlite3* _dbObject; ///< Object for accessing the SQLite database.
+                std::unique_ptr<statement_cache> _statementCache; ///< Prepared statements that are reused by PrepareCached().
+                std::unique_ptr<statement_profiler> _profiler; ///< Statement profiler, or empty if profiling is disabled.
+                std::unique_ptr<wal_hook> _walHook; ///< Callback registered by WalHook(), or empty.
+                std::shared_ptr<statement_status> _finalizedStatus; ///< Summed counters of the prepared statements that were finalized.
 
             public:
                 /**
@@ -32,6 +60,15 @@ namespace sqlitelib
                  */
                 sqlite(STRING dbFilePath, int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
 
+                /**
+                 * @brief Construct an object from a path to a file and apply settings to the connection.
+                 * @details The connection is closed again if a setting cannot be applied, so no partly configured
+                 * connection is returned.
+                 * @param dbFilePath String object containing the path to the database file.
+                 * @param options Open flags and pragmas of the connection.
+                 */
+                sqlite(STRING dbFilePath, const open_options& options);
+
                 /**
                  * @brief Copy constructor.
                  * @param src Reference to an existing instance of the class.
@@ -93,6 +130,16 @@ namespace sqlitelib
                  */
                  void Exec(const std::string& sql, exec_result& resultProcessor);
 
+                /**
+                 * @brief Execute SQL statements and stream the results as typed values.
+                 * @details Each statement is prepared and stepped directly instead of going through sqlite3_exec(), so
+                 * numeric values are not converted to text and text values are not copied. Processing stops without an
+                 * error when \c RowData() returns \c false.
+                 * @param sql Semicolon-separated SQL statements.
+                 * @param resultProcessor Object derived from exec_stream that will be called to process the results.
+                 */
+                 void Exec(const std::string& sql, exec_stream& resultProcessor);
+
                 /**
                  * @brief Gets the number of rows changed by the last \c INSERT, \c DELETE, or \c UPDATE statement.
                  * @returns Returns a count of the number of rows changed.
@@ -109,6 +156,208 @@ namespace sqlitelib
                   * @returns Returns the row id of the last inserted row.
                   */
                  int64_t LastInsertRowID();
+
+                 /**
+                  * @brief Check if the connection is in autocommit mode.
+                  * @retval true No transaction is active.
+                  * @retval false A transaction is active.
+                  */
+                 bool AutoCommit();
+
+                 /**
+                  * @brief Get the size of the memory-mapped window of a database file.
+                  * @param dbName Name of the attached database.
+                  * @returns Returns the maximum number of bytes of the file that are accessed through memory-mapped
+                  * I/O, or 0 if reads go through the page cache only, for example for in-memory databases.
+                  */
+                 int64_t MmapSize(const std::string& dbName = "main");
+
+            public:
+                /**
+                 * @brief Get a prepared statement from the statement cache of the connection. The statement is prepared
+                 * on the first request for \p sql and reused afterwards.
+                 * @param sql SQL statement.
+                 * @returns Returns a lease on the statement. The statement is reset and its bindings are cleared when the
+                 * lease is destroyed. The lease must not outlive this object.
+                 */
+                 cached_statement PrepareCached(const std::string& sql);
+
+                /**
+                 * @brief Set the maximum number of statements kept by the statement cache.
+                 * @param capacity Maximum number of statements. Zero disables caching.
+                 */
+                 void StatementCacheCapacity(size_t capacity);
+
+                /**
+                 * @brief Get the hit, miss and eviction counters of the statement cache.
+                 * @returns Returns a snapshot of the counters.
+                 */
+                 statement_cache_stats StatementCacheStats() const;
+
+                /**
+                 * @brief Reset the hit, miss and eviction counters of the statement cache to zero.
+                 */
+                 void ResetStatementCacheStats();
+
+                /**
+                 * @brief Finalize all idle statements in the statement cache.
+                 */
+                 void ClearStatementCache();
+
+            #if SQLITE_VERSION_NUMBER >= 3023000
+            public:
+                /**
+                 * @brief Get an image of a database.
+                 * @details The image of an in-memory database, such as one loaded with Deserialize(), refers to the
+                 * memory of the database without copying it where SQLite allows it. Other databases are copied.
+                 * @param dbName Name of the attached database.
+                 * @returns Returns the image.
+                 */
+                 serialized_database Serialize(const std::string& dbName = "main");
+
+                /**
+                 * @brief Replace a database with a copy of an image. The database becomes an in-memory database that
+                 * can grow.
+                 * @param data The image.
+                 * @param size Size of the image in bytes.
+                 * @param dbName Name of the attached database.
+                 */
+                 void Deserialize(const void* data, size_t size, const std::string& dbName = "main");
+
+                /**
+                 * @brief Replace a database with an image without copying it, if the image is owned. An image that
+                 * refers to another database is copied.
+                 * @param image The image. It is empty after the call.
+                 * @param dbName Name of the attached database.
+                 */
+                 void Deserialize(serialized_database&& image, const std::string& dbName = "main");
+
+                /**
+                 * @brief Open an image as a read-only database without copying it, for example a memory-mapped file.
+                 * @param data The image, which must stay valid and unchanged until the database is closed or replaced.
+                 * @param size Size of the image in bytes.
+                 * @param dbName Name of the attached database.
+                 */
+                 void DeserializeReadOnly(const void* data, size_t size, const std::string& dbName = "main");
+            #endif // SQLITE_VERSION_NUMBER
+
+            public:
+                /**
+                 * @brief Run a checkpoint of the WAL file.
+                 * @param mode Mode of the checkpoint.
+                 * @param dbName Name of the attached database. An empty name checkpoints all attached databases.
+                 * @returns Returns the number of frames in the WAL file and the number of frames checkpointed. A
+                 * checkpoint that was blocked by other connections is reported with \c busy set instead of an exception.
+                 */
+                 checkpoint_result Checkpoint(checkpoint_mode mode = checkpoint_mode::passive, const std::string& dbName = "main");
+
+                /**
+                 * @brief Set the number of WAL frames after which a commit runs a passive checkpoint on the committing
+                 * thread. This replaces the callback registered by WalHook().
+                 * @param frames Number of frames. Zero or a negative value disables automatic checkpoints.
+                 */
+                 void WalAutoCheckpoint(int frames);
+
+                /**
+                 * @brief Register a callback that is called after each commit in WAL mode. This replaces automatic
+                 * checkpoints; call WalAutoCheckpoint() to enable them again.
+                 * @param hook The callback, which must not use this connection. An empty callback removes the hook.
+                 */
+                 void WalHook(wal_hook hook);
+
+            public:
+                /**
+                 * @brief Register a scalar SQL function implemented by a callable object. The number and the types of
+                 * the arguments and the type of the result are deduced from the signature of the callable object, see
+                 * function_argument and function_result. A \c void result returns NULL. Exceptions thrown by the
+                 * callable object are reported as the error of the SQL statement.
+                 * @param name Name of the SQL function.
+                 * @param function The callable object, which is copied or moved into the connection and destroyed when
+                 * the function is replaced or the connection is closed.
+                 * @param flags Properties of the function.
+                 */
+                template <typename Function> void CreateFunction(const std::string& name, Function&& function, function_flags flags = function_flags::none);
+
+                /**
+                 * @brief Register an aggregate SQL function implemented by a class, see aggregate_function. An instance
+                 * of the class is constructed in place for each group, so the rows are aggregated while the query runs
+                 * instead of being materialized first.
+                 * @param name Name of the SQL function.
+                 * @param flags Properties of the function.
+                 */
+                template <typename Aggregate> void CreateAggregate(const std::string& name, function_flags flags = function_flags::none);
+
+            #if SQLITE_VERSION_NUMBER >= 3025000
+                /**
+                 * @brief Register an aggregate SQL function that can also be used as a window function, see
+                 * aggregate_function. The class must implement \c Inverse() and \c Value() in addition to \c Step() and
+                 * \c Final(), so SQLite can slide the window frame without aggregating the whole frame again.
+                 * @param name Name of the SQL function.
+                 * @param flags Properties of the function.
+                 */
+                template <typename Aggregate> void CreateWindowFunction(const std::string& name, function_flags flags = function_flags::none);
+            #endif // SQLITE_VERSION_NUMBER
+
+                /**
+                 * @brief Remove a SQL function.
+                 * @param name Name of the SQL function.
+                 * @param argumentCount Number of arguments of the function, or -1 for a function with any number of
+                 * arguments.
+                 */
+                 void RemoveFunction(const std::string& name, int argumentCount);
+
+            public:
+                /**
+                 * @brief Get the page cache, lookaside and memory statistics of the connection, together with the memory
+                 * statistics of the process. Subtract two snapshots to get the activity in between.
+                 * @param reset Flag that is set to reset the highest values and the hit, miss and write counters of the
+                 * connection after they are read.
+                 * @returns Returns a snapshot of the statistics.
+                 */
+                 connection_stats Stats(bool reset = false);
+
+                /**
+                 * @brief Get the sum of the performance counters of all prepared statements of the connection,
+                 * including the statements held by the statement cache.
+                 * @details The counters of a \c prepared_statement are added to a total of the connection when it is
+                 * destroyed or evicted from the statement cache, so the sum also covers statements that no longer
+                 * exist. \c memoryUsed only counts live statements.
+                 * @param reset Flag that is set to reset the counters of the statements and the total of finalized
+                 * statements after they are read.
+                 * @returns Returns the summed counters.
+                 */
+                 statement_status StatementStatus(bool reset = false);
+
+                /**
+                 * @brief Get the performance counters of each live prepared statement of the connection, including the
+                 * statements held by the statement cache.
+                 * @param statusOut Reference to a vector that receives the SQL text and the counters of each statement.
+                 * @param reset Flag that is set to reset the counters of the statements after they are read.
+                 */
+                 void StatementStatus(std::vector< std::pair<std::string, statement_status> >& statusOut, bool reset = false);
+
+            public:
+                /**
+                 * @brief Start collecting the run time of each statement of the connection. Statistics collected
+                 * earlier are discarded.
+                 * @param slowThresholdNanoseconds Minimum run time of a query written to the slow query log. Zero
+                 * disables the log.
+                 * @param slowLogCapacity Maximum number of entries kept in the slow query log.
+                 * @returns Returns the profiler, which is owned by the connection.
+                 */
+                 statement_profiler& EnableProfiling(uint64_t slowThresholdNanoseconds = 0u, size_t slowLogCapacity = 100u);
+
+                /**
+                 * @brief Stop collecting statement run times and discard the statistics.
+                 */
+                 void DisableProfiling();
+
+                /**
+                 * @brief Get the statement profiler of the connection.
+                 * @returns Returns the profiler, or \c nullptr if profiling is disabled.
+                 */
+                 statement_profiler* Profiler();
+
             public:
                 /**
                  * @brief Check if the \p sqlStatement is a complete SQL statement.
@@ -136,17 +385,75 @@ namespace sqlitelib
                  */
                 static int ExecCallback(void* userData, int numFields, char** fieldValues, char** fieldNames);
 
+                /**
+                 * @brief Called by SQLite after a commit in WAL mode to call the callback registered by WalHook().
+                 * @param userData Points to the callback.
+                 * @param dbObject The connection.
+                 * @param dbName Name of the database that was written.
+                 * @param frames Number of frames in the WAL file.
+                 * @returns Returns \c SQLITE_OK.
+                 */
+                static int WalHookCallback(void* userData, sqlite3* dbObject, const char* dbName, int frames);
+
+                /**
+                 * @brief Register a SQL function with \c sqlite3_create_function_v2().
+                 * @param name Name of the SQL function.
+                 * @param argumentCount Number of arguments.
+                 * @param flags Properties of the function.
+                 * @param userData The callable object. It is destroyed with \p destroy, also if the registration fails.
+                 * @param function Called for a scalar function, else \c nullptr.
+                 * @param step Called for each row of an aggregate function, else \c nullptr.
+                 * @param final Called at the end of an aggregate function, else \c nullptr.
+                 * @param destroy Destroys the callable object.
+                 */
+                void RegisterFunction(const std::string& name, int argumentCount, function_flags flags, void* userData, void (*function)(sqlite3_context*, int, sqlite3_value**), void (*step)(sqlite3_context*, int, sqlite3_value**), void (*final)(sqlite3_context*), void (*destroy)(void*));
+
+            #if SQLITE_VERSION_NUMBER >= 3025000
+                /**
+                 * @brief Register a window function with \c sqlite3_create_window_function().
+                 * @param name Name of the SQL function.
+                 * @param argumentCount Number of arguments.
+                 * @param flags Properties of the function.
+                 * @param step Called for each row that enters the window.
+                 * @param final Called at the end of the group.
+                 * @param value Called to get the current result.
+                 * @param inverse Called for each row that leaves the window.
+                 */
+                void RegisterWindowFunction(const std::string& name, int argumentCount, function_flags flags, void (*step)(sqlite3_context*, int, sqlite3_value**), void (*final)(sqlite3_context*), void (*value)(sqlite3_context*), void (*inverse)(sqlite3_context*, int, sqlite3_value**));
+            #endif // SQLITE_VERSION_NUMBER
+
                 static std::vector<std::string> StringsArrayToVector(size_t fieldCount, char** fieldValues);
 
                 static std::vector< std::pair< std::string, std::string > > StringsArrayToVector(size_t fieldCount, char** fieldNames, char** fieldValues);
 
-                static std::string sqlite::Utf16ToUtf8String(const std::wstring& utf16String);
+                static std::string Utf16ToUtf8String(const std::wstring& utf16String);
         }; // class sqlite
 
         inline bool sqlite::DbFileName(std::string& fileNameOut)
         {
             return DbFileName("main", fileNameOut);
         }
+
+        template <typename Function> void sqlite::CreateFunction(const std::string& name, Function&& function, function_flags flags)
+        {
+            using callable = typename std::decay<Function>::type;
+            using adapter = scalar_function<callable>;
+            this->RegisterFunction(name, function_traits<callable>::arity, flags, new callable(std::forward<Function>(function)), &adapter::Invoke, nullptr, nullptr, &adapter::Destroy);
+        }
+
+        template <typename Aggregate> void sqlite::CreateAggregate(const std::string& name, function_flags flags)
+        {
+            using adapter = aggregate_function<Aggregate>;
+            this->RegisterFunction(name, adapter::step_traits::arity, flags, nullptr, nullptr, &adapter::Step, &adapter::Final, nullptr);
+        }
+
+        #if SQLITE_VERSION_NUMBER >= 3025000
+        template <typename Aggregate> void sqlite::CreateWindowFunction(const std::string& name, function_flags flags)
+        {
+            using adapter = aggregate_function<Aggregate>;
+            this->RegisterWindowFunction(name, adapter::step_traits::arity, flags, &adapter::Step, &adapter::Final, &adapter::Value, &adapter::Inverse);
+        }
+        #endif // SQLITE_VERSION_NUMBER
     } // namespace SQLite3
 } // namespace sqlitelib
 
@@ -6,7 +6,7 @@ namespace sqlitelib
     using std::string;
 
     sqlite_exception::sqlite_exception(int returnCode)
-        :   runtime_error(nullptr),
+        :   runtime_error(sqlite3_errstr(returnCode)),
             _returnCode(returnCode)
     {
     }
@@ -18,7 +18,7 @@ namespace sqlitelib
     }
 
     sqlite_exception::sqlite_exception(int returnCode, const char* what)
-        :   runtime_error(what),
+        :   runtime_error((nullptr == what) ? sqlite3_errstr(returnCode) : what),
             _returnCode(returnCode)
     {
     }
@@ -4,6 +4,18 @@
 #include <sqlite3.h>
 #include <sqlite.hpp>
 #include <prepared_statement.hpp>
+#include <statement_cache.hpp>
+#include <statement_profiler.hpp>
+#include <backup.hpp>
+#include <blob_stream.hpp>
+#include <wal_checkpointer.hpp>
+#include <transaction.hpp>
+#include <bulk_inserter.hpp>
+#include <connection_pool.hpp>
+#include <typed_query.hpp>
+#include <container_table.hpp>
+#include <async_executor.hpp>
+#include <generator.hpp>
 #include <StepStatementProcessing.hpp>
 
 namespace sqlitelib
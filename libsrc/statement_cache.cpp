@@ -0,0 +1,216 @@
+#include "statement_cache.hpp"
+#include "sqlite_exception.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::string;
+        using std::unique_ptr;
+
+        cached_statement::cached_statement(statement_cache* cachePtr, entry_iterator entry)
+            :   _cachePtr(cachePtr),
+                _entry(entry),
+                _ownedPtr(),
+                _statementPtr(entry->statementPtr.get())
+        {
+        }
+
+        cached_statement::cached_statement(statement_cache* cachePtr, unique_ptr<prepared_statement>&& statementPtr)
+            :   _cachePtr(cachePtr),
+                _entry(),
+                _ownedPtr(std::move(statementPtr)),
+                _statementPtr(nullptr)
+        {
+            this->_statementPtr = this->_ownedPtr.get();
+        }
+
+        cached_statement::cached_statement(cached_statement&& src)
+            :   _cachePtr(src._cachePtr),
+                _entry(src._entry),
+                _ownedPtr(std::move(src._ownedPtr)),
+                _statementPtr(src._statementPtr)
+        {
+            src._statementPtr = nullptr;
+        }
+
+        cached_statement::~cached_statement()
+        {
+            try
+            {
+                this->Release();
+            }
+            catch (...)
+            {
+                // Destructors must not throw.
+            }
+        }
+
+        cached_statement& cached_statement::operator=(cached_statement&& src)
+        {
+            if (this != &src)
+            {
+                this->Release();
+                this->_cachePtr = src._cachePtr;
+                this->_entry = src._entry;
+                this->_ownedPtr = std::move(src._ownedPtr);
+                this->_statementPtr = src._statementPtr;
+                src._statementPtr = nullptr;
+            }
+
+            return *this;
+        }
+
+        void cached_statement::Release()
+        {
+            if (nullptr == this->_statementPtr)
+            {
+                return;
+            }
+
+            prepared_statement* statementPtr = this->_statementPtr;
+            this->_statementPtr = nullptr;
+
+            if (this->_ownedPtr)
+            {
+                this->_ownedPtr.reset();
+                return;
+            }
+
+            try
+            {
+                statementPtr->Reset();
+            }
+            catch (const sqlite_exception&)
+            {
+                // sqlite3_reset() repeats the error of the last step, but the statement is reset regardless.
+            }
+
+            try
+            {
+                statementPtr->ClearBindings();
+            }
+            catch (const sqlite_exception&)
+            {
+                // The statement may still refer to values of the caller, so it is finalized instead of reused. Either
+                // way the entry does not stay leased for the rest of the connection's life.
+                this->_cachePtr->Discard(this->_entry);
+                throw;
+            }
+
+            this->_cachePtr->Return(this->_entry);
+        }
+
+        statement_cache::statement_cache(size_t capacity)
+            :   _capacity(capacity),
+                _entries(),
+                _index(),
+                _hits(0u),
+                _misses(0u),
+                _evictions(0u)
+        {
+        }
+
+        statement_cache::~statement_cache()
+        {
+        }
+
+        cached_statement statement_cache::Acquire(sqlite& dbObject, const string& sql)
+        {
+            auto found = this->_index.find(sql);
+            if (found != this->_index.end())
+            {
+                entry_list::iterator entry = found->second;
+                if (!entry->leased)
+                {
+                    ++this->_hits;
+                    entry->leased = true;
+                    this->_entries.splice(this->_entries.begin(), this->_entries, entry);
+                    return cached_statement(this, entry);
+                }
+            }
+
+            ++this->_misses;
+            unique_ptr<prepared_statement> statementPtr(new prepared_statement(dbObject, sql));
+
+            if ((this->_capacity == 0u) || (found != this->_index.end()))
+            {
+                // Caching is disabled, or the cached statement for this SQL text is already leased.
+                return cached_statement(this, std::move(statementPtr));
+            }
+
+            this->_entries.push_front(statement_cache_entry{ sql, std::move(statementPtr), true });
+            this->_index.emplace(sql, this->_entries.begin());
+            this->Trim(this->_capacity);
+
+            return cached_statement(this, this->_entries.begin());
+        }
+
+        void statement_cache::Capacity(size_t capacity)
+        {
+            this->_capacity = capacity;
+            this->Trim(capacity);
+        }
+
+        statement_cache_stats statement_cache::Stats() const
+        {
+            statement_cache_stats result;
+            result.hits = this->_hits;
+            result.misses = this->_misses;
+            result.evictions = this->_evictions;
+            result.size = this->_entries.size();
+            result.capacity = this->_capacity;
+            return result;
+        }
+
+        void statement_cache::ResetStats()
+        {
+            this->_hits = 0u;
+            this->_misses = 0u;
+            this->_evictions = 0u;
+        }
+
+        void statement_cache::Clear()
+        {
+            entry_list::iterator entry = this->_entries.begin();
+            while (entry != this->_entries.end())
+            {
+                if (entry->leased)
+                {
+                    ++entry;
+                    continue;
+                }
+
+                this->_index.erase(entry->sql);
+                entry = this->_entries.erase(entry);
+            }
+        }
+
+        void statement_cache::Return(entry_list::iterator entry)
+        {
+            entry->leased = false;
+            this->Trim(this->_capacity);
+        }
+
+        void statement_cache::Discard(entry_list::iterator entry)
+        {
+            this->_index.erase(entry->sql);
+            this->_entries.erase(entry);
+        }
+
+        void statement_cache::Trim(size_t capacity)
+        {
+            entry_list::iterator entry = this->_entries.end();
+            while ((this->_entries.size() > capacity) && (entry != this->_entries.begin()))
+            {
+                --entry;
+                if (!entry->leased)
+                {
+                    this->_index.erase(entry->sql);
+                    entry = this->_entries.erase(entry);
+                    ++this->_evictions;
+                }
+            }
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
@@ -0,0 +1,231 @@
+#if !defined STATEMENT_CACHE_BB0AB32CCFEF460D816674433F5C255D
+#define STATEMENT_CACHE_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "prepared_statement.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        class sqlite;
+        class statement_cache;
+
+        /**
+         * @brief Counters maintained by a statement_cache.
+         */
+        struct statement_cache_stats
+        {
+            uint64_t hits;      ///< Number of requests served from the cache.
+            uint64_t misses;    ///< Number of requests that had to prepare a new statement.
+            uint64_t evictions; ///< Number of statements finalized because the cache was full.
+            size_t size;        ///< Number of statements currently held by the cache, including leased ones.
+            size_t capacity;    ///< Maximum number of statements held by the cache.
+        }; // struct statement_cache_stats
+
+        /**
+         * @brief Entry of a statement_cache.
+         */
+        struct statement_cache_entry
+        {
+            std::string sql;                                    ///< SQL text that is used as the cache key.
+            std::unique_ptr<prepared_statement> statementPtr;   ///< The cached statement.
+            bool leased;                                        ///< Flag that is set while the statement is handed out.
+        }; // struct statement_cache_entry
+
+        /**
+         * @brief Lease on a prepared statement taken from a statement_cache.
+         * @details The statement is reset, its bindings are cleared and it is handed back to the cache when the lease
+         * is destroyed. A lease must not outlive the \c sqlite object it was obtained from.
+         */
+        class cached_statement
+        {
+            friend class statement_cache;
+
+            private:
+                using entry_iterator = std::list<statement_cache_entry>::iterator;
+
+            private:
+                statement_cache* _cachePtr;                     ///< Cache that receives the statement on release.
+                entry_iterator _entry;                          ///< Cache entry of the statement. Only valid if \c _ownedPtr is empty.
+                std::unique_ptr<prepared_statement> _ownedPtr;  ///< Statement that is not tracked by the cache.
+                prepared_statement* _statementPtr;              ///< The leased statement.
+
+            private:
+                /**
+                 * @brief Construct a lease on a statement that is tracked by the cache.
+                 * @param cachePtr Cache that receives the statement on release.
+                 * @param entry Cache entry of the statement.
+                 */
+                cached_statement(statement_cache* cachePtr, entry_iterator entry);
+
+                /**
+                 * @brief Construct a lease on a statement that is finalized on release.
+                 * @param cachePtr Cache that issued the lease.
+                 * @param statementPtr The leased statement.
+                 */
+                cached_statement(statement_cache* cachePtr, std::unique_ptr<prepared_statement>&& statementPtr);
+
+            public:
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                cached_statement(const cached_statement& src) = delete;
+
+                /**
+                 * @brief Move constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                cached_statement(cached_statement&& src);
+
+                /**
+                 * @brief Destructor. Returns the statement to the cache.
+                 */
+                ~cached_statement();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                cached_statement& operator=(const cached_statement& src) = delete;
+
+                /**
+                 * @brief Move assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                cached_statement& operator=(cached_statement&& src);
+
+                /**
+                 * @brief Access the leased statement.
+                 */
+                inline prepared_statement& operator*() const;
+
+                /**
+                 * @brief Access the leased statement.
+                 */
+                inline prepared_statement* operator->() const;
+
+                /**
+                 * @brief Return the statement to the cache before the lease goes out of scope.
+                 */
+                void Release();
+        }; // class cached_statement
+
+        /**
+         * @brief Bounded cache of prepared statements keyed by SQL text. The least recently used statement is
+         * finalized when the cache is full.
+         * @details A statement is marked as leased while it is handed out. A second request for the same SQL text while
+         * the statement is leased gets a fresh statement that is finalized on release, so leases never share a statement.
+         * The cache and its leases must not be used from more than one thread at a time.
+         */
+        class statement_cache
+        {
+            friend class cached_statement;
+
+            private:
+                using entry_list = std::list<statement_cache_entry>;
+
+            private:
+                size_t _capacity;                                                   ///< Maximum number of cached statements.
+                entry_list _entries;                                                ///< Cached statements, most recently used first.
+                std::unordered_map<std::string, entry_list::iterator> _index;       ///< Lookup of entries by SQL text.
+                uint64_t _hits;                                                     ///< Number of cache hits.
+                uint64_t _misses;                                                   ///< Number of cache misses.
+                uint64_t _evictions;                                                ///< Number of evicted statements.
+
+            public:
+                /**
+                 * @brief Construct an empty cache.
+                 * @param capacity Maximum number of cached statements. Zero disables caching.
+                 */
+                explicit statement_cache(size_t capacity);
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                statement_cache(const statement_cache& src) = delete;
+
+                /**
+                 * @brief Destructor. Finalizes all cached statements. No leases may be outstanding.
+                 */
+                ~statement_cache();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                statement_cache& operator=(const statement_cache& src) = delete;
+
+            public:
+                /**
+                 * @brief Take a statement from the cache, or prepare a new one on a miss.
+                 * @param dbObject Connection on which a new statement is prepared.
+                 * @param sql SQL statement.
+                 * @returns Returns a lease on the statement.
+                 */
+                cached_statement Acquire(sqlite& dbObject, const std::string& sql);
+
+                /**
+                 * @brief Change the maximum number of cached statements. Excess idle statements are evicted.
+                 * @param capacity Maximum number of cached statements. Zero disables caching.
+                 */
+                void Capacity(size_t capacity);
+
+                /**
+                 * @brief Get the cache counters.
+                 * @returns Returns a snapshot of the counters.
+                 */
+                statement_cache_stats Stats() const;
+
+                /**
+                 * @brief Reset the hit, miss and eviction counters to zero.
+                 */
+                void ResetStats();
+
+                /**
+                 * @brief Finalize all idle statements. Leased statements are not affected.
+                 */
+                void Clear();
+
+            private:
+                /**
+                 * @brief Called by cached_statement to hand a tracked statement back.
+                 * @param entry Cache entry of the statement.
+                 */
+                void Return(entry_list::iterator entry);
+
+                /**
+                 * @brief Called by cached_statement to finalize a tracked statement that could not be cleaned up.
+                 * @param entry Cache entry of the statement.
+                 */
+                void Discard(entry_list::iterator entry);
+
+                /**
+                 * @brief Finalize idle statements, least recently used first, until the cache holds at most
+                 * \p capacity entries.
+                 * @param capacity Number of statements to retain.
+                 */
+                void Trim(size_t capacity);
+        }; // class statement_cache
+
+        inline prepared_statement& cached_statement::operator*() const
+        {
+            return *this->_statementPtr;
+        }
+
+        inline prepared_statement* cached_statement::operator->() const
+        {
+            return this->_statementPtr;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // STATEMENT_CACHE_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,457 @@
+#include "statement_profiler.hpp"
+#include "DataTypes.hpp"
+#include "sqlite_exception.hpp"
+#include <algorithm>
+#include <cctype>
+#include <iomanip>
+#include <iterator>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::string;
+        using std::vector;
+
+        latency_histogram::latency_histogram()
+            :   _count(0u),
+                _totalNanoseconds(0u),
+                _maxNanoseconds(0u)
+        {
+            for (std::atomic<uint64_t>& bucket : this->_buckets)
+            {
+                bucket.store(0u, std::memory_order_relaxed);
+            }
+        }
+
+        void latency_histogram::Record(uint64_t nanoseconds)
+        {
+            this->_buckets[BucketIndex(nanoseconds)].fetch_add(1u, std::memory_order_relaxed);
+            this->_count.fetch_add(1u, std::memory_order_relaxed);
+            this->_totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+            uint64_t currentMax = this->_maxNanoseconds.load(std::memory_order_relaxed);
+            while ((nanoseconds > currentMax) && !this->_maxNanoseconds.compare_exchange_weak(currentMax, nanoseconds, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        uint64_t latency_histogram::Percentile(double percent) const
+        {
+            uint64_t count = this->Count();
+            if (count == 0u)
+            {
+                return 0u;
+            }
+
+            // Rank of the requested value, counting from 1.
+            double rank = (percent / 100.0) * (double)count;
+            uint64_t target = (rank < 1.0) ? 1u : (uint64_t)rank;
+            if ((double)target < rank)
+            {
+                ++target;
+            }
+
+            uint64_t maxNanoseconds = this->MaxNanoseconds();
+            uint64_t seen = 0u;
+            for (size_t index = 0u; index < BucketCount; ++index)
+            {
+                seen += this->_buckets[index].load(std::memory_order_relaxed);
+                if (seen >= target)
+                {
+                    return std::min(BucketUpperBound(index), maxNanoseconds);
+                }
+            }
+
+            // Values recorded while the buckets were read.
+            return maxNanoseconds;
+        }
+
+        void latency_histogram::Reset()
+        {
+            for (std::atomic<uint64_t>& bucket : this->_buckets)
+            {
+                bucket.store(0u, std::memory_order_relaxed);
+            }
+
+            this->_count.store(0u, std::memory_order_relaxed);
+            this->_totalNanoseconds.store(0u, std::memory_order_relaxed);
+            this->_maxNanoseconds.store(0u, std::memory_order_relaxed);
+        }
+
+        size_t latency_histogram::BucketIndex(uint64_t nanoseconds)
+        {
+            if (nanoseconds < 4u)
+            {
+                return (size_t)nanoseconds;
+            }
+
+            // Position of the highest set bit.
+            size_t highBit = 0u;
+            for (size_t shift = 32u; shift > 0u; shift /= 2u)
+            {
+                if ((nanoseconds >> (highBit + shift)) != 0u)
+                {
+                    highBit += shift;
+                }
+            }
+
+            // The two bits below the highest set bit select one of four buckets.
+            size_t subBucket = (size_t)(nanoseconds >> (highBit - 2u)) & 3u;
+            return (highBit - 1u) * 4u + subBucket;
+        }
+
+        uint64_t latency_histogram::BucketUpperBound(size_t index)
+        {
+            if (index < 4u)
+            {
+                return (uint64_t)index;
+            }
+
+            size_t highBit = index / 4u + 1u;
+            uint64_t width = (uint64_t)1u << (highBit - 2u);
+            return (uint64_t)(4u + index % 4u) * width + (width - 1u);
+        }
+
+        statement_profiler::statement_profiler(sqlite3* dbObject, uint64_t slowThresholdNanoseconds, size_t slowLogCapacity)
+            :   _dbObject(dbObject),
+                _slowThresholdNanoseconds(slowThresholdNanoseconds),
+                _slowLogCapacity(slowLogCapacity),
+                _mutex(),
+                _histograms(),
+                _statements(),
+                _slowLog()
+        {
+            int rc = sqlite3_trace_v2(this->_dbObject, SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE, statement_profiler::TraceCallback, this);
+            if (rc != SQLITE_OK)
+            {
+                throw sqlite_exception(rc, ROUTINE_NAME);
+            }
+        }
+
+        statement_profiler::~statement_profiler()
+        {
+            sqlite3_trace_v2(this->_dbObject, 0u, nullptr, nullptr);
+        }
+
+        vector<statement_profile> statement_profiler::Profiles() const
+        {
+            vector<statement_profile> result;
+            {
+                std::lock_guard<std::mutex> lock(this->_mutex);
+                result.reserve(this->_histograms.size());
+                for (const auto& entry : this->_histograms)
+                {
+                    const latency_histogram& histogram = *entry.second;
+
+                    statement_profile profile;
+                    profile.sql = entry.first;
+                    profile.count = histogram.Count();
+                    profile.totalNanoseconds = histogram.TotalNanoseconds();
+                    profile.p50Nanoseconds = histogram.Percentile(50.0);
+                    profile.p99Nanoseconds = histogram.Percentile(99.0);
+                    profile.maxNanoseconds = histogram.MaxNanoseconds();
+                    result.push_back(std::move(profile));
+                }
+            }
+
+            std::sort(result.begin(), result.end(), [](const statement_profile& left, const statement_profile& right)
+            {
+                return left.totalNanoseconds > right.totalNanoseconds;
+            });
+
+            return result;
+        }
+
+        vector<slow_query> statement_profiler::SlowQueries() const
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            return vector<slow_query>(this->_slowLog.begin(), this->_slowLog.end());
+        }
+
+        void statement_profiler::Report(std::ostream& stream) const
+        {
+            vector<statement_profile> profiles = this->Profiles();
+            std::ios_base::fmtflags flags = stream.flags();
+            std::streamsize precision = stream.precision();
+
+            stream << std::setw(10) << "count" << std::setw(14) << "total ms" << std::setw(12) << "p50 us"
+                << std::setw(12) << "p99 us" << std::setw(12) << "max us" << "  sql\n";
+
+            stream << std::fixed << std::setprecision(3);
+            for (const statement_profile& profile : profiles)
+            {
+                stream << std::setw(10) << profile.count
+                    << std::setw(14) << profile.totalNanoseconds / 1e6
+                    << std::setw(12) << profile.p50Nanoseconds / 1e3
+                    << std::setw(12) << profile.p99Nanoseconds / 1e3
+                    << std::setw(12) << profile.maxNanoseconds / 1e3
+                    << "  " << profile.sql << '\n';
+            }
+
+            stream.flags(flags);
+            stream.precision(precision);
+        }
+
+        void statement_profiler::SlowQueryLog(std::ostream& stream) const
+        {
+            vector<slow_query> queries = this->SlowQueries();
+            std::ios_base::fmtflags flags = stream.flags();
+            std::streamsize precision = stream.precision();
+
+            stream << std::fixed << std::setprecision(3);
+            for (const slow_query& query : queries)
+            {
+                stream << query.nanoseconds / 1e6 << " ms  " << query.sql << '\n';
+            }
+
+            stream.flags(flags);
+            stream.precision(precision);
+        }
+
+        void statement_profiler::Reset()
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            for (auto& entry : this->_histograms)
+            {
+                entry.second->Reset();
+            }
+
+            this->_slowLog.clear();
+        }
+
+        string statement_profiler::NormalizeSql(const char* sql)
+        {
+            string result;
+            bool pendingSpace = false;
+            const char* current = sql;
+
+            while (*current != '\0')
+            {
+                unsigned char character = (unsigned char)*current;
+
+                // Whitespace and comments collapse to one space.
+                if (std::isspace(character))
+                {
+                    pendingSpace = true;
+                    ++current;
+                    continue;
+                }
+
+                if ((current[0] == '-') && (current[1] == '-'))
+                {
+                    while ((*current != '\0') && (*current != '\n'))
+                    {
+                        ++current;
+                    }
+
+                    pendingSpace = true;
+                    continue;
+                }
+
+                if ((current[0] == '/') && (current[1] == '*'))
+                {
+                    current += 2;
+                    while ((*current != '\0') && !((current[0] == '*') && (current[1] == '/')))
+                    {
+                        ++current;
+                    }
+
+                    current += (*current != '\0') ? 2 : 0;
+                    pendingSpace = true;
+                    continue;
+                }
+
+                if (pendingSpace && !result.empty())
+                {
+                    result.push_back(' ');
+                }
+
+                pendingSpace = false;
+
+                // Digits that follow an identifier or a parameter prefix are not literals.
+                bool previousIsWord = !result.empty() && (std::isalnum((unsigned char)result.back()) || (string("_?:@$").find(result.back()) != string::npos));
+
+                // String and blob literals.
+                if ((character == '\'') || (((character == 'x') || (character == 'X')) && (current[1] == '\'') && !previousIsWord))
+                {
+                    current += (character == '\'') ? 1 : 2;
+                    while (*current != '\0')
+                    {
+                        if (*current == '\'')
+                        {
+                            if (current[1] != '\'')
+                            {
+                                ++current;
+                                break;
+                            }
+
+                            ++current;
+                        }
+
+                        ++current;
+                    }
+
+                    result.push_back('?');
+                    continue;
+                }
+
+                // Numeric literals, which do not follow an identifier character.
+                if ((std::isdigit(character) || ((character == '.') && std::isdigit((unsigned char)current[1]))) && !previousIsWord)
+                {
+                    while ((std::isalnum((unsigned char)*current)) || (*current == '.')
+                        || (((*current == '+') || (*current == '-')) && ((current[-1] == 'e') || (current[-1] == 'E'))))
+                    {
+                        ++current;
+                    }
+
+                    result.push_back('?');
+                    continue;
+                }
+
+                // Quoted identifiers are copied unchanged.
+                if ((character == '"') || (character == '`') || (character == '['))
+                {
+                    char closing = (character == '[') ? ']' : (char)character;
+                    result.push_back(*current++);
+                    while ((*current != '\0') && (*current != closing))
+                    {
+                        result.push_back(*current++);
+                    }
+
+                    if (*current != '\0')
+                    {
+                        result.push_back(*current++);
+                    }
+
+                    continue;
+                }
+
+                result.push_back(*current++);
+            }
+
+            return result;
+        }
+
+        statement_profiler::statement_entry* statement_profiler::Entry(sqlite3_stmt* statementPtr)
+        {
+            const char* sql = sqlite3_sql(statementPtr);
+            if (nullptr == sql)
+            {
+                return nullptr;
+            }
+
+            auto found = this->_statements.find(statementPtr);
+            if ((found != this->_statements.end()) && (found->second.sql.compare(sql) == 0))
+            {
+                return &found->second;
+            }
+
+            // Statements are not reported when they are finalized, so entries of idle statements are dropped once there
+            // are many. They are created again on the next run.
+            if ((found == this->_statements.end()) && (this->_statements.size() >= MaxStatementEntries))
+            {
+                for (auto entry = this->_statements.begin(); entry != this->_statements.end(); )
+                {
+                    entry = entry->second.running ? std::next(entry) : this->_statements.erase(entry);
+                }
+            }
+
+            latency_histogram* histogramPtr;
+            {
+                std::lock_guard<std::mutex> lock(this->_mutex);
+                std::unique_ptr<latency_histogram>& histogram = this->_histograms[NormalizeSql(sql)];
+                if (!histogram)
+                {
+                    histogram.reset(new latency_histogram());
+                }
+
+                histogramPtr = histogram.get();
+            }
+
+            statement_entry& entry = this->_statements[statementPtr];
+            entry.sql.assign(sql);
+            entry.histogram = histogramPtr;
+            entry.running = false;
+            return &entry;
+        }
+
+        void statement_profiler::Start(sqlite3_stmt* statementPtr)
+        {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            statement_entry* entry = this->Entry(statementPtr);
+
+            // Statements run by triggers report another start event for the statement that is already running.
+            if ((nullptr != entry) && !entry->running)
+            {
+                entry->started = now;
+                entry->running = true;
+            }
+        }
+
+        void statement_profiler::Record(sqlite3_stmt* statementPtr, uint64_t sqliteNanoseconds)
+        {
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            uint64_t nanoseconds = sqliteNanoseconds;
+
+            // A running statement cannot have been replaced since it started, so its entry needs no check.
+            auto found = this->_statements.find(statementPtr);
+            statement_entry* entry = ((found != this->_statements.end()) && found->second.running) ? &found->second : this->Entry(statementPtr);
+            if (nullptr == entry)
+            {
+                return;
+            }
+
+            if (entry->running)
+            {
+                nanoseconds = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - entry->started).count();
+                entry->running = false;
+            }
+
+            latency_histogram* histogramPtr = entry->histogram;
+            histogramPtr->Record(nanoseconds);
+
+            if ((this->_slowThresholdNanoseconds == 0u) || (nanoseconds < this->_slowThresholdNanoseconds) || (this->_slowLogCapacity == 0u))
+            {
+                return;
+            }
+
+            slow_query query;
+            char* expandedSql = sqlite3_expanded_sql(statementPtr);
+            query.sql.assign((nullptr == expandedSql) ? entry->sql.c_str() : expandedSql);
+            query.nanoseconds = nanoseconds;
+            sqlite3_free(expandedSql);
+
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            if (this->_slowLog.size() >= this->_slowLogCapacity)
+            {
+                this->_slowLog.pop_front();
+            }
+
+            this->_slowLog.push_back(std::move(query));
+        }
+
+        int statement_profiler::TraceCallback(unsigned eventType, void* context, void* statement, void* detail)
+        {
+            statement_profiler* profilerPtr = (statement_profiler*)context;
+
+            try
+            {
+                if (eventType == SQLITE_TRACE_STMT)
+                {
+                    profilerPtr->Start((sqlite3_stmt*)statement);
+                }
+                else if (eventType == SQLITE_TRACE_PROFILE)
+                {
+                    profilerPtr->Record((sqlite3_stmt*)statement, (uint64_t)*(sqlite3_int64*)detail);
+                }
+            }
+            catch (...)
+            {
+                // Profiling must not make a statement fail.
+            }
+
+            return 0;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
@@ -0,0 +1,278 @@
+#if !defined STATEMENT_PROFILER_BB0AB32CCFEF460D816674433F5C255D
+#define STATEMENT_PROFILER_BB0AB32CCFEF460D816674433F5C255D
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sqlite3.h>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Histogram of statement run times with logarithmic buckets.
+         * @details Each power of two is divided into four buckets, so a percentile is accurate to about 20%. Values
+         * are recorded with atomic operations only and may be read while other threads record.
+         */
+        class latency_histogram
+        {
+            public:
+                static const size_t BucketCount = 256u; ///< Number of buckets.
+
+            private:
+                std::atomic<uint64_t> _buckets[BucketCount];    ///< Number of values per bucket.
+                std::atomic<uint64_t> _count;                   ///< Number of recorded values.
+                std::atomic<uint64_t> _totalNanoseconds;        ///< Sum of the recorded values.
+                std::atomic<uint64_t> _maxNanoseconds;          ///< Largest recorded value.
+
+            public:
+                /**
+                 * @brief Construct an empty histogram.
+                 */
+                latency_histogram();
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                latency_histogram(const latency_histogram& src) = delete;
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                latency_histogram& operator=(const latency_histogram& src) = delete;
+
+            public:
+                /**
+                 * @brief Record a run time.
+                 * @param nanoseconds The run time in nanoseconds.
+                 */
+                void Record(uint64_t nanoseconds);
+
+                /**
+                 * @brief Estimate a percentile of the recorded values.
+                 * @param percent Percentile between 0 and 100.
+                 * @returns Returns the upper bound of the bucket that holds the percentile, but not more than the largest
+                 * recorded value, or 0 if the histogram is empty.
+                 */
+                uint64_t Percentile(double percent) const;
+
+                /**
+                 * @brief Returns the number of recorded values.
+                 */
+                inline uint64_t Count() const;
+
+                /**
+                 * @brief Returns the sum of the recorded values in nanoseconds.
+                 */
+                inline uint64_t TotalNanoseconds() const;
+
+                /**
+                 * @brief Returns the largest recorded value in nanoseconds.
+                 */
+                inline uint64_t MaxNanoseconds() const;
+
+                /**
+                 * @brief Clear the histogram.
+                 */
+                void Reset();
+
+            private:
+                /**
+                 * @brief Get the bucket of a value.
+                 * @param nanoseconds The value.
+                 * @returns Returns the index of the bucket.
+                 */
+                static size_t BucketIndex(uint64_t nanoseconds);
+
+                /**
+                 * @brief Get the largest value of a bucket.
+                 * @param index Index of the bucket.
+                 * @returns Returns the upper bound of the bucket.
+                 */
+                static uint64_t BucketUpperBound(size_t index);
+        }; // class latency_histogram
+
+        /**
+         * @brief Run time statistics of one normalized SQL statement.
+         */
+        struct statement_profile
+        {
+            std::string sql;            ///< Normalized SQL text.
+            uint64_t count;             ///< Number of runs.
+            uint64_t totalNanoseconds;  ///< Total run time.
+            uint64_t p50Nanoseconds;    ///< Estimated median run time.
+            uint64_t p99Nanoseconds;    ///< Estimated 99th percentile of the run time.
+            uint64_t maxNanoseconds;    ///< Longest run time.
+        }; // struct statement_profile
+
+        /**
+         * @brief Entry of the slow query log.
+         */
+        struct slow_query
+        {
+            std::string sql;        ///< SQL text with the bound parameter values expanded.
+            uint64_t nanoseconds;   ///< Run time.
+        }; // struct slow_query
+
+        /**
+         * @brief Collects the run time of each statement of a connection through \c sqlite3_trace_v2().
+         * @details Run times are aggregated per normalized SQL text, where literals are replaced by \c ? and runs of
+         * whitespace are collapsed, so statements that differ only in inlined values share one histogram. Runs that
+         * take at least the slow query threshold are logged with their parameter values expanded. The run time is
+         * measured with \c std::chrono::steady_clock from the \c SQLITE_TRACE_STMT event to the \c SQLITE_TRACE_PROFILE
+         * event, because the time that SQLite reports has millisecond resolution on most platforms. The trace callback
+         * finds the histogram through the statement handle, so a run takes the mutex only when a new SQL text is seen or
+         * a slow query is logged. Memory grows with the number of normalized SQL texts, not with the number of distinct
+         * inlined values.
+         */
+        class statement_profiler
+        {
+            private:
+                sqlite3* _dbObject;                                                 ///< The profiled connection.
+                uint64_t _slowThresholdNanoseconds;                                 ///< Minimum run time of a logged query. Zero disables the log.
+                size_t _slowLogCapacity;                                            ///< Maximum number of entries of the slow query log.
+                /**
+                 * @brief Histogram and start time of a prepared statement.
+                 */
+                struct statement_entry
+                {
+                    std::string sql;                                ///< SQL text of the statement, to detect a reused address.
+                    latency_histogram* histogram;                   ///< Histogram of the normalized SQL text.
+                    std::chrono::steady_clock::time_point started;  ///< Start of the current run.
+                    bool running;                                   ///< Flag that is set while the statement runs.
+                };
+
+                static const size_t MaxStatementEntries = 1024u;   ///< Number of statements above which idle entries are dropped.
+
+                mutable std::mutex _mutex;                                          ///< Protects the histogram map and the slow query log.
+                std::unordered_map< std::string, std::unique_ptr<latency_histogram> > _histograms; ///< Histograms by normalized SQL text.
+                std::unordered_map<sqlite3_stmt*, statement_entry> _statements;     ///< Entries by statement. Only used by the trace callback, which SQLite does not call concurrently for one connection.
+                std::deque<slow_query> _slowLog;                                    ///< The most recent slow queries.
+
+            public:
+                /**
+                 * @brief Register the profiler with a connection.
+                 * @param dbObject The connection.
+                 * @param slowThresholdNanoseconds Minimum run time of a query written to the slow query log. Zero
+                 * disables the log.
+                 * @param slowLogCapacity Maximum number of entries kept in the slow query log.
+                 */
+                statement_profiler(sqlite3* dbObject, uint64_t slowThresholdNanoseconds, size_t slowLogCapacity);
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                statement_profiler(const statement_profiler& src) = delete;
+
+                /**
+                 * @brief Destructor. Unregisters the profiler.
+                 */
+                ~statement_profiler();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                statement_profiler& operator=(const statement_profiler& src) = delete;
+
+            public:
+                /**
+                 * @brief Get the statistics of all profiled statements.
+                 * @returns Returns the statistics, sorted by descending total run time.
+                 */
+                std::vector<statement_profile> Profiles() const;
+
+                /**
+                 * @brief Get the slow query log.
+                 * @returns Returns the logged queries, oldest first.
+                 */
+                std::vector<slow_query> SlowQueries() const;
+
+                /**
+                 * @brief Write a table of the statistics of all profiled statements.
+                 * @param stream Stream that receives the report.
+                 */
+                void Report(std::ostream& stream) const;
+
+                /**
+                 * @brief Write the slow query log, one query per line.
+                 * @param stream Stream that receives the log.
+                 */
+                void SlowQueryLog(std::ostream& stream) const;
+
+                /**
+                 * @brief Clear the statistics and the slow query log.
+                 */
+                void Reset();
+
+                /**
+                 * @brief Replace the literals of a SQL text by \c ? and collapse whitespace.
+                 * @param sql The SQL text.
+                 * @returns Returns the normalized text.
+                 */
+                static std::string NormalizeSql(const char* sql);
+
+            private:
+                /**
+                 * @brief Remember the start time of a statement.
+                 * @param statementPtr The statement.
+                 */
+                void Start(sqlite3_stmt* statementPtr);
+
+                /**
+                 * @brief Get the entry of a statement, creating it or replacing it if the address now belongs to a
+                 * statement with another SQL text.
+                 * @param statementPtr The statement.
+                 * @returns Returns the entry, or \c nullptr if the statement has no SQL text.
+                 */
+                statement_entry* Entry(sqlite3_stmt* statementPtr);
+
+                /**
+                 * @brief Record a run of a statement.
+                 * @param statementPtr The statement.
+                 * @param sqliteNanoseconds Run time of the statement reported by SQLite.
+                 */
+                void Record(sqlite3_stmt* statementPtr, uint64_t sqliteNanoseconds);
+
+                /**
+                 * @brief Callback registered with \c sqlite3_trace_v2().
+                 * @param eventType The trace event, either \c SQLITE_TRACE_STMT or \c SQLITE_TRACE_PROFILE.
+                 * @param context Points to the instance of the \c statement_profiler class.
+                 * @param statement The statement that starts or has finished.
+                 * @param detail For \c SQLITE_TRACE_PROFILE, points to the run time of the statement in nanoseconds.
+                 * @returns Returns 0.
+                 */
+                static int TraceCallback(unsigned eventType, void* context, void* statement, void* detail);
+        }; // class statement_profiler
+
+        inline uint64_t latency_histogram::Count() const
+        {
+            return this->_count.load(std::memory_order_relaxed);
+        }
+
+        inline uint64_t latency_histogram::TotalNanoseconds() const
+        {
+            return this->_totalNanoseconds.load(std::memory_order_relaxed);
+        }
+
+        inline uint64_t latency_histogram::MaxNanoseconds() const
+        {
+            return this->_maxNanoseconds.load(std::memory_order_relaxed);
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // STATEMENT_PROFILER_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,49 @@
+#include "statement_status.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        statement_status::statement_status()
+            :   fullscanSteps(0u),
+                sorts(0u),
+                autoIndexes(0u),
+                vmSteps(0u),
+                reprepares(0u),
+                runs(0u),
+                memoryUsed(0u)
+        {
+        }
+
+        statement_status& statement_status::operator+=(const statement_status& other)
+        {
+            this->fullscanSteps += other.fullscanSteps;
+            this->sorts += other.sorts;
+            this->autoIndexes += other.autoIndexes;
+            this->vmSteps += other.vmSteps;
+            this->reprepares += other.reprepares;
+            this->runs += other.runs;
+            this->memoryUsed += other.memoryUsed;
+            return *this;
+        }
+
+        statement_status statement_status::Read(sqlite3_stmt* statementPtr, bool reset)
+        {
+            int resetFlag = reset ? 1 : 0;
+
+            statement_status result;
+            result.fullscanSteps = (uint64_t)sqlite3_stmt_status(statementPtr, SQLITE_STMTSTATUS_FULLSCAN_STEP, resetFlag);
+            result.sorts = (uint64_t)sqlite3_stmt_status(statementPtr, SQLITE_STMTSTATUS_SORT, resetFlag);
+            result.autoIndexes = (uint64_t)sqlite3_stmt_status(statementPtr, SQLITE_STMTSTATUS_AUTOINDEX, resetFlag);
+            result.vmSteps = (uint64_t)sqlite3_stmt_status(statementPtr, SQLITE_STMTSTATUS_VM_STEP, resetFlag);
+
+            #if SQLITE_VERSION_NUMBER >= 3020000
+                result.reprepares = (uint64_t)sqlite3_stmt_status(statementPtr, SQLITE_STMTSTATUS_REPREPARE, resetFlag);
+                result.runs = (uint64_t)sqlite3_stmt_status(statementPtr, SQLITE_STMTSTATUS_RUN, resetFlag);
+                result.memoryUsed = (uint64_t)sqlite3_stmt_status(statementPtr, SQLITE_STMTSTATUS_MEMUSED, 0);
+            #endif // SQLITE_VERSION_NUMBER
+
+            return result;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
@@ -0,0 +1,50 @@
+#if !defined STATEMENT_STATUS_BB0AB32CCFEF460D816674433F5C255D
+#define STATEMENT_STATUS_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstdint>
+#include <sqlite3.h>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Performance counters of prepared statements, read with \c sqlite3_stmt_status().
+         * @details The counters tell whether a query scanned a whole table, sorted or built an automatic index, which
+         * usually means that an index is missing. \c reprepares, \c runs and \c memoryUsed need SQLite 3.20 or later
+         * and are zero with older versions.
+         */
+        struct statement_status
+        {
+            uint64_t fullscanSteps; ///< Number of times a full table scan moved to the next row.
+            uint64_t sorts;         ///< Number of sort operations.
+            uint64_t autoIndexes;   ///< Number of rows inserted into automatic indexes.
+            uint64_t vmSteps;       ///< Number of virtual machine operations.
+            uint64_t reprepares;    ///< Number of times the statement was prepared again after a schema change.
+            uint64_t runs;          ///< Number of times the statement was run.
+            uint64_t memoryUsed;    ///< Bytes of heap memory used by the statement. This is not reset.
+
+            /**
+             * @brief Construct a status with all counters set to zero.
+             */
+            statement_status();
+
+            /**
+             * @brief Add the counters of another status.
+             * @param other The status to add.
+             * @returns Returns a reference to this object.
+             */
+            statement_status& operator+=(const statement_status& other);
+
+            /**
+             * @brief Read the counters of a statement.
+             * @param statementPtr Handle of the statement.
+             * @param reset Flag that is set to reset the counters after they are read.
+             * @returns Returns the counters.
+             */
+            static statement_status Read(sqlite3_stmt* statementPtr, bool reset);
+        }; // struct statement_status
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // STATEMENT_STATUS_BB0AB32CCFEF460D816674433F5C255D
@@ -0,0 +1,123 @@
+#include "transaction.hpp"
+#include "statement_cache.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::string;
+
+        /**
+         * @brief Run a statement that is taken from the statement cache of the connection.
+         * @param dbObject Reference to a \c sqlite object.
+         * @param sql SQL statement.
+         */
+        static void ExecuteCached(sqlite& dbObject, const string& sql)
+        {
+            cached_statement statement = dbObject.PrepareCached(sql);
+            statement->Execute();
+        }
+
+        transaction::transaction(sqlite& dbObject, transaction_mode mode)
+            :   _dbObject(dbObject),
+                _active(false)
+        {
+            static const string beginSql[] = { "BEGIN DEFERRED", "BEGIN IMMEDIATE", "BEGIN EXCLUSIVE" };
+
+            ExecuteCached(this->_dbObject, beginSql[(int)mode]);
+            this->_active = true;
+        }
+
+        transaction::~transaction()
+        {
+            try
+            {
+                this->Rollback();
+            }
+            catch (...)
+            {
+                // Destructors must not throw.
+            }
+        }
+
+        void transaction::Commit()
+        {
+            static const string commitSql("COMMIT");
+
+            if (!this->_active)
+            {
+                return;
+            }
+
+            ExecuteCached(this->_dbObject, commitSql);
+            this->_active = false;
+        }
+
+        void transaction::Rollback()
+        {
+            static const string rollbackSql("ROLLBACK");
+
+            if (!this->_active)
+            {
+                return;
+            }
+
+            this->_active = false;
+
+            // SQLite rolls back on its own after some errors, in which case there is nothing left to undo.
+            if (!this->_dbObject.AutoCommit())
+            {
+                ExecuteCached(this->_dbObject, rollbackSql);
+            }
+        }
+
+        savepoint::savepoint(sqlite& dbObject, const string& name)
+            :   _dbObject(dbObject),
+                _name(name),
+                _active(false)
+        {
+            ExecuteCached(this->_dbObject, "SAVEPOINT " + this->_name);
+            this->_active = true;
+        }
+
+        savepoint::~savepoint()
+        {
+            try
+            {
+                this->Rollback();
+            }
+            catch (...)
+            {
+                // Destructors must not throw.
+            }
+        }
+
+        void savepoint::Release()
+        {
+            if (!this->_active)
+            {
+                return;
+            }
+
+            ExecuteCached(this->_dbObject, "RELEASE " + this->_name);
+            this->_active = false;
+        }
+
+        void savepoint::Rollback()
+        {
+            if (!this->_active)
+            {
+                return;
+            }
+
+            this->_active = false;
+
+            if (!this->_dbObject.AutoCommit())
+            {
+                // ROLLBACK TO undoes the changes but keeps the savepoint on the stack.
+                ExecuteCached(this->_dbObject, "ROLLBACK TO " + this->_name);
+                ExecuteCached(this->_dbObject, "RELEASE " + this->_name);
+            }
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
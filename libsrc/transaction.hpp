@@ -0,0 +1,164 @@
+#if !defined TRANSACTION_BB0AB32CCFEF460D816674433F5C255D
+#define TRANSACTION_BB0AB32CCFEF460D816674433F5C255D
+
+#include <string>
+#include "sqlite.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Locking behaviour of a transaction.
+         */
+        enum class transaction_mode
+        {
+            deferred = 0,   ///< Locks are acquired when the database is first accessed.
+            immediate,      ///< A write lock is acquired when the transaction starts.
+            exclusive       ///< An exclusive lock is acquired when the transaction starts.
+        }; // enum class transaction_mode
+
+        /**
+         * @brief Scope guard for a transaction. The transaction is rolled back when the object is destroyed without a
+         * call to Commit(), for example when an exception leaves the scope.
+         * @details The BEGIN, COMMIT and ROLLBACK statements are taken from the statement cache of the connection.
+         */
+        class transaction
+        {
+            private:
+                sqlite& _dbObject;  ///< Connection on which the transaction runs.
+                bool _active;       ///< Flag that is set while the transaction has not been committed or rolled back.
+
+            public:
+                /**
+                 * @brief Begin a transaction.
+                 * @param dbObject Reference to a \c sqlite object.
+                 * @param mode Locking behaviour of the transaction.
+                 */
+                explicit transaction(sqlite& dbObject, transaction_mode mode = transaction_mode::deferred);
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                transaction(const transaction& src) = delete;
+
+                /**
+                 * @brief Destructor. Rolls back the transaction if it is still active.
+                 */
+                ~transaction();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                transaction& operator=(const transaction& src) = delete;
+
+            public:
+                /**
+                 * @brief Commit the transaction. The transaction stays active if the commit fails.
+                 */
+                void Commit();
+
+                /**
+                 * @brief Roll back the transaction.
+                 */
+                void Rollback();
+
+                /**
+                 * @brief Check if the transaction has not been committed or rolled back yet.
+                 * @retval true The transaction is active.
+                 * @retval false The transaction has ended.
+                 */
+                inline bool IsActive() const;
+
+            public:
+                /**
+                 * @brief Call \p function inside a transaction. The transaction is committed if \p function returns
+                 * and rolled back if it throws.
+                 * @param dbObject Reference to a \c sqlite object.
+                 * @param function Callable object without parameters.
+                 * @param mode Locking behaviour of the transaction.
+                 */
+                template <typename Function> static void Run(sqlite& dbObject, Function&& function, transaction_mode mode = transaction_mode::deferred);
+        }; // class transaction
+
+        /**
+         * @brief Scope guard for a savepoint. Savepoints can be nested inside each other and inside a transaction.
+         * The savepoint is rolled back when the object is destroyed without a call to Release().
+         * @details Nested savepoints may share a name, because SQLite always refers to the most recent savepoint with a
+         * given name. The statements are taken from the statement cache of the connection.
+         */
+        class savepoint
+        {
+            private:
+                sqlite& _dbObject;  ///< Connection on which the savepoint is created.
+                std::string _name;  ///< Name of the savepoint.
+                bool _active;       ///< Flag that is set while the savepoint has not been released or rolled back.
+
+            public:
+                /**
+                 * @brief Create a savepoint.
+                 * @param dbObject Reference to a \c sqlite object.
+                 * @param name Name of the savepoint. The name must be a valid SQL identifier.
+                 */
+                explicit savepoint(sqlite& dbObject, const std::string& name = "sqlitelib_savepoint");
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                savepoint(const savepoint& src) = delete;
+
+                /**
+                 * @brief Destructor. Rolls back the savepoint if it is still active.
+                 */
+                ~savepoint();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                savepoint& operator=(const savepoint& src) = delete;
+
+            public:
+                /**
+                 * @brief Release the savepoint, keeping its changes.
+                 */
+                void Release();
+
+                /**
+                 * @brief Undo all changes since the savepoint was created and release it.
+                 */
+                void Rollback();
+
+                /**
+                 * @brief Check if the savepoint has not been released or rolled back yet.
+                 * @retval true The savepoint is active.
+                 * @retval false The savepoint has ended.
+                 */
+                inline bool IsActive() const;
+        }; // class savepoint
+
+        inline bool transaction::IsActive() const
+        {
+            return this->_active;
+        }
+
+        template <typename Function> void transaction::Run(sqlite& dbObject, Function&& function, transaction_mode mode)
+        {
+            transaction scope(dbObject, mode);
+            function();
+            scope.Commit();
+        }
+
+        inline bool savepoint::IsActive() const
+        {
+            return this->_active;
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // TRANSACTION_BB0AB32CCFEF460D816674433F5C255D
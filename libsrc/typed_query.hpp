@@ -0,0 +1,222 @@
+#if !defined TYPED_QUERY_BB0AB32CCFEF460D816674433F5C255D
+#define TYPED_QUERY_BB0AB32CCFEF460D816674433F5C255D
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "prepared_statement.hpp"
+#include "row_iterator.hpp"
+#include "sqlite_exception.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Reads a column of a result_row as type \p T. Specializations exist for \c int, \c int64_t, \c double,
+         * \c std::string, \c std::vector<uint8_t>, \c text_view and \c blob_span. \c OwnsValue is \c false for the
+         * types that point into the statement and become invalid when it steps.
+         */
+        template <typename T> struct column_reader;
+
+        template <> struct column_reader<int>
+        {
+            static const bool OwnsValue = true;
+            static inline int Read(const result_row& row, int index) { return row.GetInt(index); }
+        };
+
+        template <> struct column_reader<int64_t>
+        {
+            static const bool OwnsValue = true;
+            static inline int64_t Read(const result_row& row, int index) { return row.GetInt64(index); }
+        };
+
+        template <> struct column_reader<double>
+        {
+            static const bool OwnsValue = true;
+            static inline double Read(const result_row& row, int index) { return row.GetDouble(index); }
+        };
+
+        template <> struct column_reader<std::string>
+        {
+            static const bool OwnsValue = true;
+            static inline std::string Read(const result_row& row, int index) { return row.GetString(index); }
+        };
+
+        template <> struct column_reader< std::vector<uint8_t> >
+        {
+            static const bool OwnsValue = true;
+            static inline std::vector<uint8_t> Read(const result_row& row, int index) { return row.GetBlob(index); }
+        };
+
+        template <> struct column_reader<text_view>
+        {
+            static const bool OwnsValue = false;
+            static inline text_view Read(const result_row& row, int index) { return row.GetStringView(index); }
+        };
+
+        template <> struct column_reader<blob_span>
+        {
+            static const bool OwnsValue = false;
+            static inline blob_span Read(const result_row& row, int index) { return row.GetBlobSpan(index); }
+        };
+
+        /**
+         * @brief Check if all types in \p Columns hold their own copy of the column value.
+         */
+        template <typename... Columns> struct columns_own_values : std::true_type
+        {
+        };
+
+        template <typename First, typename... Rest> struct columns_own_values<First, Rest...>
+            :   std::integral_constant<bool, column_reader<First>::OwnsValue && columns_own_values<Rest...>::value>
+        {
+        };
+
+        /**
+         * @brief Query whose result columns have the types \p Columns.
+         * @details The column count is checked once when the statement is prepared. The getter for each column is
+         * selected at compile time, so decoding a row involves no type dispatch. Columns of type \c text_view or
+         * \c blob_span are only valid inside ForEach(), and Fetch() and FetchAs() do not compile with them.
+         */
+        template <typename... Columns> class typed_query
+        {
+            public:
+                using row_type = std::tuple<Columns...>; ///< Type of a decoded row.
+
+            private:
+                prepared_statement _statement; ///< The underlying statement.
+
+            public:
+                /**
+                 * @brief Prepare the query.
+                 * @param dbObject Reference to a \c sqlite object.
+                 * @param sql SQL statement that returns one column per type in \p Columns.
+                 */
+                typed_query(sqlite& dbObject, const std::string& sql);
+
+            public:
+                /**
+                 * @brief Reset the statement and bind new parameter values.
+                 * @param params One value per parameter, of a type accepted by prepared_statement::Bind().
+                 * @returns Returns a reference to this object.
+                 */
+                template <typename... Params> typed_query& Bind(const Params&... params);
+
+                /**
+                 * @brief Run the query and call \p function with the decoded columns of each row.
+                 * @details The statement is reset if \p function throws, so it holds no read transaction afterwards.
+                 * @param function Callable object that takes one argument per type in \p Columns.
+                 */
+                template <typename Function> void ForEach(Function&& function);
+
+                /**
+                 * @brief Run the query and collect the decoded rows.
+                 * @returns Returns one tuple per row.
+                 */
+                std::vector<row_type> Fetch();
+
+                /**
+                 * @brief Run the query and decode each row into a structure.
+                 * @param fields Pointers to the members of \p Struct that receive the columns, in column order.
+                 * @returns Returns one structure per row.
+                 */
+                template <typename Struct> std::vector<Struct> FetchAs(Columns Struct::*... fields);
+
+                /**
+                 * @brief Access the underlying statement.
+                 */
+                inline prepared_statement& Statement();
+
+            private:
+                /**
+                 * @brief Decode the columns of a row and pass them to \p function.
+                 */
+                template <typename Function, size_t... Indexes> static void Invoke(Function& function, const result_row& row, std::index_sequence<Indexes...>);
+        }; // class typed_query
+
+        template <typename... Columns> typed_query<Columns...>::typed_query(sqlite& dbObject, const std::string& sql)
+            :   _statement(dbObject, sql)
+        {
+            if (this->_statement.ResultColumnsCount() != (int)sizeof...(Columns))
+            {
+                throw sqlite_exception(SQLITE_MISMATCH, "Column count of the query does not match the column types: " + sql);
+            }
+        }
+
+        template <typename... Columns> template <typename... Params> typed_query<Columns...>& typed_query<Columns...>::Bind(const Params&... params)
+        {
+            this->_statement.Reset();
+            this->_statement.ClearBindings();
+
+            int paramIndex = 0;
+            int expansion[] = { 0, (this->_statement.Bind(++paramIndex, params), 0)... };
+            (void)expansion;
+
+            return *this;
+        }
+
+        template <typename... Columns> template <typename Function> void typed_query<Columns...>::ForEach(Function&& function)
+        {
+            try
+            {
+                for (const result_row& row : this->_statement.Rows())
+                {
+                    Invoke(function, row, std::index_sequence_for<Columns...>());
+                }
+            }
+            catch (...)
+            {
+                try
+                {
+                    this->_statement.Reset();
+                }
+                catch (const sqlite_exception&)
+                {
+                    // sqlite3_reset() repeats the error of the last step, but the statement is reset regardless.
+                }
+
+                throw;
+            }
+        }
+
+        template <typename... Columns> std::vector<typename typed_query<Columns...>::row_type> typed_query<Columns...>::Fetch()
+        {
+            static_assert(columns_own_values<Columns...>::value, "Fetch() cannot return text_view or blob_span columns, which are only valid inside ForEach().");
+
+            std::vector<row_type> result;
+            this->ForEach([&result](const Columns&... values) { result.emplace_back(values...); });
+            return result;
+        }
+
+        template <typename... Columns> template <typename Struct> std::vector<Struct> typed_query<Columns...>::FetchAs(Columns Struct::*... fields)
+        {
+            static_assert(columns_own_values<Columns...>::value, "FetchAs() cannot return text_view or blob_span columns, which are only valid inside ForEach().");
+
+            std::vector<Struct> result;
+            this->ForEach([&result, fields...](const Columns&... values)
+            {
+                result.emplace_back();
+                Struct& item = result.back();
+                int expansion[] = { 0, ((item.*fields = values), 0)... };
+                (void)expansion;
+            });
+            return result;
+        }
+
+        template <typename... Columns> inline prepared_statement& typed_query<Columns...>::Statement()
+        {
+            return this->_statement;
+        }
+
+        template <typename... Columns> template <typename Function, size_t... Indexes> void typed_query<Columns...>::Invoke(Function& function, const result_row& row, std::index_sequence<Indexes...>)
+        {
+            function(column_reader<Columns>::Read(row, (int)Indexes)...);
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // TYPED_QUERY_BB0AB32CCFEF460D816674433F5C255D
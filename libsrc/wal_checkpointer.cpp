@@ -0,0 +1,221 @@
+#include "wal_checkpointer.hpp"
+#include "prepared_statement.hpp"
+#include "sqlite_exception.hpp"
+#include <chrono>
+#include <codecvt>
+#include <locale>
+#include <string>
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        using std::string;
+
+        /**
+         * @brief Get the automatic checkpoint threshold of a connection.
+         * @param dbObject The connection.
+         * @returns Returns the number of frames, or zero if automatic checkpoints are disabled or replaced by a WAL hook.
+         */
+        static int AutoCheckpointFrames(sqlite& dbObject)
+        {
+            int frames = 0;
+            prepared_statement statement(dbObject, "PRAGMA wal_autocheckpoint");
+            for (const result_row& row : statement.Rows())
+            {
+                frames = row.GetInt(0);
+            }
+
+            return frames;
+        }
+
+        wal_checkpointer::wal_checkpointer(sqlite& writer, const wal_checkpointer_options& options)
+            :   _writer(writer),
+                _connection(DbFilePath(writer), SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX),
+                _options(options),
+                _stats(),
+                _walFrames(0),
+                _committed(false),
+                _logFrames(0),
+                _checkpointedFrames(0),
+                _previousAutoCheckpoint(0),
+                _stopping(false),
+                _mutex(),
+                _wakeUp(),
+                _thread()
+        {
+            // Full, restart and truncate checkpoints wait for the writer and the readers instead of failing at once.
+            this->_connection.Exec("PRAGMA busy_timeout = " + std::to_string(options.busyTimeoutMilliseconds));
+
+            // Reading the database makes the new connection open the WAL file, which a checkpoint needs.
+            this->_connection.Exec("PRAGMA schema_version");
+            this->_previousAutoCheckpoint = AutoCheckpointFrames(writer);
+
+            // The thread is started first, so a failure to start it leaves no hook behind that points to this object.
+            this->_thread = std::thread([this]() { this->ThreadLoop(); });
+
+            try
+            {
+                // Registering the hook replaces the automatic checkpoints of the writer.
+                this->_writer.WalHook([this](const string& dbName, int frames)
+                {
+                    if (dbName == "main")
+                    {
+                        this->Committed(frames);
+                    }
+                });
+            }
+            catch (...)
+            {
+                this->StopThread();
+                throw;
+            }
+        }
+
+        wal_checkpointer::~wal_checkpointer()
+        {
+            try
+            {
+                // Restoring the automatic checkpoints removes the hook.
+                this->_writer.WalAutoCheckpoint(this->_previousAutoCheckpoint);
+            }
+            catch (...)
+            {
+                // Destructors must not throw, but the hook must not outlive this object.
+                this->_writer.WalHook(wal_hook());
+            }
+
+            this->StopThread();
+        }
+
+        wal_checkpointer_stats wal_checkpointer::Stats()
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            return this->_stats;
+        }
+
+        void wal_checkpointer::Committed(int frames)
+        {
+            bool thresholdReached;
+            {
+                std::lock_guard<std::mutex> lock(this->_mutex);
+                this->_walFrames = frames;
+                this->_committed = true;
+                thresholdReached = (frames >= this->_options.framesThreshold);
+            }
+
+            if (thresholdReached)
+            {
+                this->_wakeUp.notify_one();
+            }
+        }
+
+        void wal_checkpointer::ThreadLoop()
+        {
+            std::unique_lock<std::mutex> lock(this->_mutex);
+            for (;;)
+            {
+                auto thresholdReached = [this]() { return this->_stopping || (this->_committed && (this->_walFrames >= this->_options.framesThreshold)); };
+                if (this->_options.intervalMilliseconds > 0)
+                {
+                    this->_wakeUp.wait_for(lock, std::chrono::milliseconds(this->_options.intervalMilliseconds), thresholdReached);
+                }
+                else
+                {
+                    this->_wakeUp.wait(lock, thresholdReached);
+                }
+
+                if (this->_stopping)
+                {
+                    return;
+                }
+
+                if (!this->_committed)
+                {
+                    continue;
+                }
+
+                this->_committed = false;
+                int walFrames = this->_walFrames;
+                bool truncate = (this->_options.truncateThreshold > 0) && (walFrames >= this->_options.truncateThreshold);
+                lock.unlock();
+
+                checkpoint_result result;
+                bool failed = false;
+                try
+                {
+                    result = this->_connection.Checkpoint(truncate ? checkpoint_mode::truncate : this->_options.mode);
+                }
+                catch (const sqlite_exception&)
+                {
+                    // For example SQLITE_LOCKED. The next commit or interval retries.
+                    failed = true;
+                }
+
+                lock.lock();
+                if (failed)
+                {
+                    continue;
+                }
+
+                // The frame counts refer to the whole WAL file, which starts over when the WAL is reset.
+                int newFrames;
+                if (truncate && !result.busy)
+                {
+                    // The counts are reported after the WAL file was emptied.
+                    newFrames = (walFrames > this->_checkpointedFrames) ? (walFrames - this->_checkpointedFrames) : 0;
+                    this->_logFrames = 0;
+                    this->_checkpointedFrames = 0;
+                }
+                else if (result.logFrames < 0)
+                {
+                    // The checkpoint did not start, for example because another connection was checkpointing.
+                    newFrames = 0;
+                }
+                else
+                {
+                    int checkpointedFrames = (result.checkpointedFrames > 0) ? result.checkpointedFrames : 0;
+                    bool walReset = (result.logFrames < this->_logFrames) || (checkpointedFrames < this->_checkpointedFrames);
+                    newFrames = walReset ? checkpointedFrames : (checkpointedFrames - this->_checkpointedFrames);
+                    this->_logFrames = result.logFrames;
+                    this->_checkpointedFrames = checkpointedFrames;
+                }
+
+                ++this->_stats.checkpoints;
+                this->_stats.busyCheckpoints += result.busy ? 1u : 0u;
+                this->_stats.truncateCheckpoints += truncate ? 1u : 0u;
+                this->_stats.framesCheckpointed += (uint64_t)newFrames;
+                this->_stats.seconds += result.seconds;
+                this->_stats.maxSeconds = (result.seconds > this->_stats.maxSeconds) ? result.seconds : this->_stats.maxSeconds;
+                this->_stats.lastLogFrames = result.logFrames;
+            }
+        }
+
+        void wal_checkpointer::StopThread()
+        {
+            {
+                std::lock_guard<std::mutex> lock(this->_mutex);
+                this->_stopping = true;
+            }
+
+            this->_wakeUp.notify_one();
+            this->_thread.join();
+        }
+
+        STRING wal_checkpointer::DbFilePath(sqlite& dbObject)
+        {
+            string fileName;
+            if (!dbObject.DbFileName(fileName) || fileName.empty())
+            {
+                throw sqlite_exception(SQLITE_MISUSE, "A WAL checkpointer needs a database file");
+            }
+
+            #ifdef _WIN32
+                std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>, wchar_t> conversion;
+                return conversion.from_bytes(fileName);
+            #else
+                return fileName;
+            #endif // _WIN32
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
@@ -0,0 +1,158 @@
+#if !defined WAL_CHECKPOINTER_BB0AB32CCFEF460D816674433F5C255D
+#define WAL_CHECKPOINTER_BB0AB32CCFEF460D816674433F5C255D
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "checkpoint_result.hpp"
+#include "sqlite.hpp"
+
+namespace sqlitelib
+{
+    namespace SQLite3
+    {
+        /**
+         * @brief Settings for a wal_checkpointer.
+         */
+        struct wal_checkpointer_options
+        {
+            int framesThreshold;        ///< Checkpoint as soon as the WAL file holds this many frames.
+
+            /**
+             * Also checkpoint after this time if there were commits since the last checkpoint. Zero disables the timer.
+             */
+            int intervalMilliseconds;
+
+            checkpoint_mode mode;       ///< Mode of the checkpoints.
+
+            /**
+             * Use checkpoint_mode::truncate while the WAL file holds this many frames, because a writer that commits
+             * continuously keeps passive checkpoints from resetting the WAL. Such a checkpoint briefly blocks the
+             * writer, which therefore needs a busy timeout. Zero disables this.
+             */
+            int truncateThreshold;
+
+            /**
+             * Time that the checkpoint connection waits for the locks of other connections in the modes that wait for
+             * them.
+             */
+            int busyTimeoutMilliseconds;
+
+            /**
+             * @brief Construct the default settings: passive checkpoints at 1000 frames, the threshold of SQLite's
+             * automatic checkpoints, or once per second, no truncate checkpoints and a busy timeout of one second.
+             */
+            inline wal_checkpointer_options();
+        }; // struct wal_checkpointer_options
+
+        /**
+         * @brief Counters maintained by a wal_checkpointer.
+         */
+        struct wal_checkpointer_stats
+        {
+            uint64_t checkpoints;           ///< Number of checkpoints run.
+            uint64_t busyCheckpoints;       ///< Number of checkpoints that could not complete because of other connections.
+            uint64_t truncateCheckpoints;   ///< Number of checkpoints run with checkpoint_mode::truncate because of the truncate threshold.
+            uint64_t framesCheckpointed;    ///< Total number of frames copied into the database file.
+            double seconds;                 ///< Total time spent in checkpoints.
+            double maxSeconds;              ///< Longest checkpoint.
+            int lastLogFrames;              ///< Number of frames in the WAL file after the last checkpoint.
+        }; // struct wal_checkpointer_stats
+
+        /**
+         * @brief Runs WAL checkpoints on a background thread, so that commits on the writer connection do not pay for
+         * them.
+         * @details The checkpointer disables the automatic checkpoints of the writer connection and registers a WAL
+         * hook on it that wakes the background thread. The thread checkpoints through its own connection to the same
+         * database. The destructor removes the hook, restores the automatic checkpoint threshold the writer had before
+         * and stops the thread. A WAL hook that was registered on the writer before is not restored.
+         */
+        class wal_checkpointer
+        {
+            private:
+                sqlite& _writer;                        ///< Connection whose commits are watched.
+                sqlite _connection;                     ///< Connection used for the checkpoints.
+                wal_checkpointer_options _options;      ///< Settings of the checkpointer.
+                wal_checkpointer_stats _stats;          ///< Counters of the checkpointer.
+                int _walFrames;                         ///< Number of WAL frames reported by the last commit.
+                bool _committed;                        ///< Flag that is set by a commit and cleared by a checkpoint.
+                int _logFrames;                         ///< Number of frames in the WAL file reported by the last checkpoint.
+                int _checkpointedFrames;                ///< Number of checkpointed frames reported by the last checkpoint.
+                int _previousAutoCheckpoint;            ///< Automatic checkpoint threshold of the writer before the hook was registered.
+                bool _stopping;                         ///< Flag that is set by the destructor.
+                std::mutex _mutex;                      ///< Protects the counters and flags.
+                std::condition_variable _wakeUp;        ///< Signalled when the threshold is reached or the checkpointer stops.
+                std::thread _thread;                    ///< The background thread.
+
+            public:
+                /**
+                 * @brief Start checkpointing the main database of a connection that is in WAL mode.
+                 * @param writer The connection whose commits are watched. It must outlive the checkpointer, and its
+                 * WAL hook must not be changed while the checkpointer exists.
+                 * @param options Settings of the checkpointer.
+                 */
+                explicit wal_checkpointer(sqlite& writer, const wal_checkpointer_options& options = wal_checkpointer_options());
+
+                /**
+                 * @brief Copy constructor.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                wal_checkpointer(const wal_checkpointer& src) = delete;
+
+                /**
+                 * @brief Destructor. Restores the automatic checkpoints of the writer and stops the background thread.
+                 */
+                ~wal_checkpointer();
+
+            public:
+                /**
+                 * @brief Copy assignment operator.
+                 * @param src Reference to an existing instance of the class.
+                 */
+                wal_checkpointer& operator=(const wal_checkpointer& src) = delete;
+
+            public:
+                /**
+                 * @brief Get the counters of the checkpointer.
+                 * @returns Returns a snapshot of the counters.
+                 */
+                wal_checkpointer_stats Stats();
+
+            private:
+                /**
+                 * @brief Called by the WAL hook of the writer after each commit.
+                 * @param frames Number of frames in the WAL file.
+                 */
+                void Committed(int frames);
+
+                /**
+                 * @brief Main loop of the background thread.
+                 */
+                void ThreadLoop();
+
+                /**
+                 * @brief Stop the background thread and wait for it to end.
+                 */
+                void StopThread();
+
+                /**
+                 * @brief Get the path of the main database of a connection.
+                 * @param dbObject The connection.
+                 * @returns Returns the path.
+                 */
+                static STRING DbFilePath(sqlite& dbObject);
+        }; // class wal_checkpointer
+
+        inline wal_checkpointer_options::wal_checkpointer_options()
+            :   framesThreshold(1000),
+                intervalMilliseconds(1000),
+                mode(checkpoint_mode::passive),
+                truncateThreshold(0),
+                busyTimeoutMilliseconds(1000)
+        {
+        }
+    } // namespace SQLite3
+} // namespace sqlitelib
+
+#endif // WAL_CHECKPOINTER_BB0AB32CCFEF460D816674433F5C255D